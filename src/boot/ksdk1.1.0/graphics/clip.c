@@ -0,0 +1,266 @@
+#include <stdint.h>
+
+#include "clip.h"
+
+#if (SCREEN_CLIPPING)
+
+    /* The far edges of the frame, at the centres of its last column and row of pixels. */
+    #define CLIP_MAX_X ( (FRAME_NUM_COLS - 1) << SUBPIXEL_BITS )
+    #define CLIP_MAX_Y ( (FRAME_NUM_ROWS - 1) << SUBPIXEL_BITS )
+
+    /* Bits of an outcode, the edges of the frame beyond which a vertex lies. */
+    typedef enum {
+        CLIP_LEFT = 1,
+        CLIP_RIGHT = 2,
+        CLIP_BOTTOM = 4,
+        CLIP_TOP = 8
+    } ClipEdges;
+
+    static uint8_t outcode(const ScreenCoord v[2])
+    {
+        return ( ((v[X] < 0) ? CLIP_LEFT : 0) | ((v[X] > CLIP_MAX_X) ? CLIP_RIGHT : 0) |
+            ((v[Y] < 0) ? CLIP_BOTTOM : 0) | ((v[Y] > CLIP_MAX_Y) ? CLIP_TOP : 0) );
+    }
+
+#endif
+
+#if (SCREEN_CLIPPING) && !(GUARD_BAND_RASTERISING)
+
+    /*
+        Finds the vertex where the line from 'inside' to 'outside', which lie on either side of one edge of the frame,
+        crosses it. The coordinate along the edge is rounded to the nearest.
+
+        The guard band keeps both products below 2^31.
+    */
+    static void intersectEdge(const ScreenCoord inside[2], const ScreenCoord outside[2], uint8_t edge, ScreenCoord result[2])
+    {
+        uint8_t across;     /* The axis across the edge. */
+        uint8_t along;      /* The axis along the edge. */
+        ScreenCoord boundary;
+        int32_t numerator;
+        int32_t denominator;
+
+        across = (edge & (CLIP_LEFT | CLIP_RIGHT)) ? X : Y;
+        along = (across == X) ? Y : X;
+
+        if (edge & (CLIP_LEFT | CLIP_BOTTOM)) {
+            boundary = 0;
+        } else {
+            boundary = (across == X) ? CLIP_MAX_X : CLIP_MAX_Y;
+        }
+
+        numerator = (int32_t) (boundary - inside[across]) * (outside[along] - inside[along]);
+        denominator = outside[across] - inside[across];
+
+        if (denominator < 0) {
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+
+        result[across] = boundary;
+        result[along] = inside[along] + ( (numerator >= 0) ?
+            (numerator + (denominator / 2)) / denominator : -((-numerator + (denominator / 2)) / denominator) );
+    }
+
+    /* Clips the convex polygon in, of num_vertices vertices, to one edge of the frame. Returns the number of vertices of out. */
+    static uint8_t clipToEdge(const ScreenCoord in[CLIP_MAX_VERTICES][2], uint8_t num_vertices, ScreenCoord out[CLIP_MAX_VERTICES][2], uint8_t edge)
+    {
+        uint8_t num_out = 0;
+        uint8_t previous = num_vertices - 1;
+        uint8_t previous_inside = !(outcode(in[previous]) & edge);
+        uint8_t current_inside;
+
+        for (uint8_t current = 0; current < num_vertices; current++) {
+            current_inside = !(outcode(in[current]) & edge);
+
+            /* The side of the polygon crosses the edge. */
+            if (current_inside && !previous_inside) {
+                intersectEdge(in[current], in[previous], edge, out[num_out++]);
+            } else if (!current_inside && previous_inside) {
+                intersectEdge(in[previous], in[current], edge, out[num_out++]);
+            }
+
+            if (current_inside) {
+                COPY_2D_VERTEX(out[num_out], in[current]);
+                num_out++;
+            }
+
+            previous = current;
+            previous_inside = current_inside;
+        }
+
+        return num_out;
+    }
+
+#endif
+
+uint8_t clip_triangle(const ScreenCoord vs[3][2], VertexCoord polygon[CLIP_MAX_VERTICES][2])
+{
+    #if (GUARD_BAND_RASTERISING)
+
+        /* Wholly beyond one edge of the frame. The rasteriser clips the rest within the guard band. */
+        if (outcode(vs[0]) & outcode(vs[1]) & outcode(vs[2])) {
+            return 0;
+        }
+
+        for (uint8_t i = 0; i < 3; i++) {
+            COPY_2D_VERTEX(polygon[i], vs[i]);
+        }
+
+        return 3;
+
+    #elif (SCREEN_CLIPPING)
+
+        ScreenCoord clipped[2][CLIP_MAX_VERTICES][2];  /* The polygon before and after clipping to each edge. */
+        uint8_t current = 0;
+        uint8_t num_vertices = 3;
+        uint8_t codes[3];
+
+        for (uint8_t i = 0; i < 3; i++) {
+            codes[i] = outcode(vs[i]);
+        }
+
+        /* Wholly beyond one edge of the frame. */
+        if (codes[0] & codes[1] & codes[2]) {
+            return 0;
+        }
+
+        /* Wholly inside the frame. */
+        if ( !(codes[0] | codes[1] | codes[2]) ) {
+            for (uint8_t i = 0; i < 3; i++) {
+                COPY_2D_VERTEX(polygon[i], vs[i]);
+            }
+
+            return 3;
+        }
+
+        for (uint8_t i = 0; i < 3; i++) {
+            COPY_2D_VERTEX(clipped[0][i], vs[i]);
+        }
+
+        /* Only the edges beyond which a vertex lies can cut the triangle. */
+        for (uint8_t edge = CLIP_LEFT; edge <= CLIP_TOP; edge <<= 1) {
+            if ( (codes[0] | codes[1] | codes[2]) & edge ) {
+                num_vertices = clipToEdge(clipped[current], num_vertices, clipped[!current], edge);
+                current = !current;
+
+                /* The triangle passes beyond a corner of the frame without covering it. */
+                if (num_vertices < 3) {
+                    return 0;
+                }
+            }
+        }
+
+        for (uint8_t i = 0; i < num_vertices; i++) {
+            COPY_2D_VERTEX(polygon[i], clipped[current][i]);
+        }
+
+        return num_vertices;
+
+    #else
+
+        for (uint8_t i = 0; i < 3; i++) {
+            COPY_2D_VERTEX(polygon[i], vs[i]);
+        }
+
+        return 3;
+
+    #endif
+}
+
+void clip_fan_triangle(const VertexCoord polygon[CLIP_MAX_VERTICES][2], uint8_t i, Triangle2D *tri2)
+{
+    COPY_2D_VERTEX(tri2->vs[0], polygon[0]);
+    COPY_2D_VERTEX(tri2->vs[1], polygon[i + 1]);
+    COPY_2D_VERTEX(tri2->vs[2], polygon[i + 2]);
+}
+
+#if (DEPTH_CLIPPING)
+
+    /* Bits of a depth outcode, the planes beyond which a camera space vertex lies. */
+    typedef enum {
+        CLIP_NEAR = 1,
+        CLIP_FAR = 2
+    } DepthClipPlanes;
+
+    uint8_t depth_outcode(const Scalar v[3])
+    {
+        return ( (((NEAR_PLANE_CLIPPING) && (v[Z] < SCALAR(NEAR_PLANE_Z))) ? CLIP_NEAR : 0) |
+            (((FAR_PLANE_CLIPPING) && (v[Z] > SCALAR(FAR_PLANE_Z))) ? CLIP_FAR : 0) );
+    }
+
+    /*
+        Finds the vertex where the line from 'inside' to 'outside', which lie on either side of one plane, crosses
+        it. The crossing lies between them, so each quotient is no larger than the difference it scales.
+    */
+    static void intersectPlane(const Scalar inside[3], const Scalar outside[3], uint8_t plane, Scalar result[3])
+    {
+        Scalar plane_z = (plane == CLIP_NEAR) ? SCALAR(NEAR_PLANE_Z) : SCALAR(FAR_PLANE_Z);
+        Scalar dz = outside[Z] - inside[Z];
+
+        result[X] = inside[X] + SCALAR_MUL_DIV(outside[X] - inside[X], plane_z - inside[Z], dz);
+        result[Y] = inside[Y] + SCALAR_MUL_DIV(outside[Y] - inside[Y], plane_z - inside[Z], dz);
+        result[Z] = plane_z;
+    }
+
+    /* Clips the convex polygon in, of num_vertices vertices, to one plane. Returns the number of vertices of out. */
+    static uint8_t clipToPlane(const Scalar in[DEPTH_CLIP_MAX_VERTICES][3], uint8_t num_vertices, Scalar out[DEPTH_CLIP_MAX_VERTICES][3], uint8_t plane)
+    {
+        uint8_t num_out = 0;
+        uint8_t previous = num_vertices - 1;
+        uint8_t previous_inside = !(depth_outcode(in[previous]) & plane);
+        uint8_t current_inside;
+
+        for (uint8_t current = 0; current < num_vertices; current++) {
+            current_inside = !(depth_outcode(in[current]) & plane);
+
+            /* The side of the polygon crosses the plane. */
+            if (current_inside && !previous_inside) {
+                intersectPlane(in[current], in[previous], plane, out[num_out++]);
+            } else if (!current_inside && previous_inside) {
+                intersectPlane(in[previous], in[current], plane, out[num_out++]);
+            }
+
+            if (current_inside) {
+                out[num_out][X] = in[current][X];
+                out[num_out][Y] = in[current][Y];
+                out[num_out][Z] = in[current][Z];
+                num_out++;
+            }
+
+            previous = current;
+            previous_inside = current_inside;
+        }
+
+        return num_out;
+    }
+
+    uint8_t clip_triangle_depth(const Triangle3D *tri3, const uint8_t codes[3], Scalar polygon[DEPTH_CLIP_MAX_VERTICES][3])
+    {
+        Scalar clipped[DEPTH_CLIP_MAX_VERTICES][3];    /* The polygon clipped to each plane, before it is copied back. */
+        uint8_t num_vertices = 3;
+
+        for (uint8_t i = 0; i < 3; i++) {
+            polygon[i][X] = tri3->vs[i][X];
+            polygon[i][Y] = tri3->vs[i][Y];
+            polygon[i][Z] = tri3->vs[i][Z];
+        }
+
+        for (uint8_t plane = CLIP_NEAR; plane <= CLIP_FAR; plane <<= 1) {
+            if ( !((codes[0] | codes[1] | codes[2]) & plane) ) {
+                continue;
+            }
+
+            num_vertices = clipToPlane(polygon, num_vertices, clipped, plane);
+
+            for (uint8_t i = 0; i < num_vertices; i++) {
+                polygon[i][X] = clipped[i][X];
+                polygon[i][Y] = clipped[i][Y];
+                polygon[i][Z] = clipped[i][Z];
+            }
+        }
+
+        return num_vertices;
+    }
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef STDINT
+	#include <stdint.h>
+	#define STDINT
+#endif
+
+#ifndef GRAPHICS
+	#include "graphics.h"
+	#define GRAPHICS
+#endif
+
+/* Clipped to the four edges of the frame, a triangle gains at most one vertex per edge. */
+#if (SCREEN_CLIPPING) && !(GUARD_BAND_RASTERISING)
+    #define CLIP_MAX_VERTICES 7
+#else
+    #define CLIP_MAX_VERTICES 3
+#endif
+
+/*
+    Clips the projected triangle vs to the frame, storing the vertices of the resulting convex polygon, in the same
+    winding as vs, in polygon. Returns their number, 0 if the triangle lies wholly off the frame.
+
+    Triangles wholly beyond one edge of the frame are rejected and triangles wholly inside it are accepted, from the
+    outcodes of their vertices alone. Others are clipped to each edge that a vertex lies beyond in turn (Sutherland
+    and Hodgman). A vertex where an edge of the triangle crosses the frame is always found from its end inside the
+    frame, so two triangles sharing the edge find the same vertex.
+
+    With GUARD_BAND_RASTERISING, the others are accepted too, as the rasteriser clips them. Without SCREEN_CLIPPING
+    the vertices are already within the frame and are copied as they are.
+*/
+uint8_t clip_triangle(const ScreenCoord vs[3][2], VertexCoord polygon[CLIP_MAX_VERTICES][2]);
+
+/*
+    Sets the vertices of tri2 to those of triangle i, from 0, of the fan from the first vertex of a polygon
+    clipped by clip_triangle(). A polygon of n vertices is n - 2 triangles.
+*/
+void clip_fan_triangle(const VertexCoord polygon[CLIP_MAX_VERTICES][2], uint8_t i, Triangle2D *tri2);
+
+/* Clipped to the near and far planes, a triangle gains at most one vertex per plane. */
+#define DEPTH_CLIP_MAX_VERTICES ( 3 + (NEAR_PLANE_CLIPPING) + (FAR_PLANE_CLIPPING) )
+
+#if (DEPTH_CLIPPING)
+    /*
+        Returns the depth outcode of the camera space vertex v, non zero if it lies nearer than the near plane or
+        beyond the far plane. A triangle whose vertices share a bit is wholly beyond that plane, one whose vertices
+        are all 0 lies wholly between them.
+    */
+    uint8_t depth_outcode(const Scalar v[3]);
+
+    /*
+        Clips the camera space triangle tri3, which crosses the near or far plane, to them, storing the vertices of
+        the resulting convex polygon, in the same winding as tri3, in polygon. Returns their number. codes are the
+        depth outcodes of the vertices of tri3.
+
+        Only the planes that a vertex lies beyond are clipped to. As in clip_triangle(), a vertex where an edge
+        crosses a plane is found from its end between the planes.
+    */
+    uint8_t clip_triangle_depth(const Triangle3D *tri3, const uint8_t codes[3], Scalar polygon[DEPTH_CLIP_MAX_VERTICES][3]);
+#endif
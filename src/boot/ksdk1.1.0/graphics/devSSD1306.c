@@ -0,0 +1,285 @@
+#include <stdint.h>
+
+#include "fsl_spi_master_driver.h"
+#include "fsl_port_hal.h"
+
+#include "SEGGER_RTT.h"
+#include "gpio_pins.h"
+#include "warp.h"
+#include "devSSD1306.h"
+
+#if (DISPLAY_BUILT(DISPLAY_SSD1306))
+
+/*
+ *	The SSD1306 is wired to the same pins as the SSD1331.
+ */
+enum
+{
+	kSSD1306PinMOSI		= GPIO_MAKE_PIN(HW_GPIOA, 8),
+	kSSD1306PinSCK		= GPIO_MAKE_PIN(HW_GPIOA, 9),
+	kSSD1306PinCSn		= GPIO_MAKE_PIN(HW_GPIOB, 11),
+	kSSD1306PinDC		= GPIO_MAKE_PIN(HW_GPIOA, 12),
+	kSSD1306PinRST		= GPIO_MAKE_PIN(HW_GPIOB, 0),
+};
+
+/* First screen column and row of the frame, which is centred on the screen, and the GDDRAM pages it covers. */
+#define SCREEN_FIRST_COL	((kSSD1306ScreenCols / 2) - (FRAME_SCREEN_COLS / 2))
+#define SCREEN_FIRST_ROW	((kSSD1306ScreenRows / 2) - (FRAME_SCREEN_ROWS / 2))
+#define SCREEN_FIRST_PAGE	(SCREEN_FIRST_ROW / kSSD1306RowsPerPage)
+#define SCREEN_LAST_PAGE	((SCREEN_FIRST_ROW + FRAME_SCREEN_ROWS - 1) / kSSD1306RowsPerPage)
+
+/* Whether each pixel of the frame is lit, bit (col % 8) of litPixels[row][col / 8]. */
+static uint8_t		litPixels[FRAME_NUM_ROWS][(FRAME_NUM_COLS + 7) / 8];
+static uint8_t		litPixelsChanged = 0;
+
+/* Window set by ssd1306SetWindow(), and its row written next by ssd1306PushPixels(). */
+static uint8_t		windowFirstCol = 0;
+static uint8_t		windowLastCol = FRAME_NUM_COLS - 1;
+static uint8_t		windowRow = 0;
+
+/*
+	Relative intensity a pixel must exceed to be lit, by its row and column, such that a 2x2 block of pixels has as
+	many lit as its relative intensity out of MAX_RELATIVE_INTENSITY, roughly. Black pixels are never lit.
+*/
+static const uint8_t ditherThresholds[2][2] =
+{
+	{0,					MAX_RELATIVE_INTENSITY / 2},
+	{(3 * MAX_RELATIVE_INTENSITY) / 4,	MAX_RELATIVE_INTENSITY / 4}
+};
+
+/* Sends bytes over SPI, returning once they have all been sent. CS and DC must already be driven. */
+static spi_status_t writeBytes(const uint8_t *bytes, uint16_t num_bytes)
+{
+	return SPI_DRV_MasterTransferBlocking(
+			0,			/* Master instance. */
+			NULL		/* spi_master_user_config_t */,
+			(const uint8_t * restrict) bytes,
+			NULL,
+			num_bytes	/* Transfer size in bytes */,
+			1000		/* Timeout in microseconds (unlike I2C which is ms) */);
+}
+
+/* Sends a list of commands with their arguments in one transfer. CS must already be driven low. */
+static spi_status_t writeCommands(const uint8_t *commands, uint8_t num_bytes)
+{
+	/* Drive DC low (command). */
+	GPIO_DRV_ClearPinOutput(kSSD1306PinDC);
+
+	return writeBytes(commands, num_bytes);
+}
+
+static void setPixel(uint8_t col, uint8_t row, uint8_t pixel_value)
+{
+	if ( (COLOUR_FROM_PIXEL_VALUE(pixel_value) != K) &&
+		(RELATIVE_INTENSITY_FROM_PIXEL_VALUE(pixel_value) > ditherThresholds[row & 1][col & 1]) ) {
+		litPixels[row][col / 8] |= 1 << (col % 8);
+	} else {
+		litPixels[row][col / 8] &= ~(1 << (col % 8));
+	}
+}
+
+void ssd1306SetWindow(uint8_t first_col, uint8_t first_row, uint8_t last_col, uint8_t last_row)
+{
+	/* The rows are written in turn from the first by ssd1306PushPixels(), which does not need the last. */
+	(void) last_row;
+
+	windowFirstCol = first_col;
+	windowLastCol = last_col;
+	windowRow = first_row;
+}
+
+void ssd1306PushPixels(const uint8_t *pixels, uint8_t num_pixels)
+{
+	uint8_t col = windowFirstCol;
+
+	for (uint8_t i = 0; (i < num_pixels) && (col <= windowLastCol); i++, col++) {
+		setPixel(col, windowRow, (pixels[i / PIXELS_PER_BYTE] >> (BITS_PER_PIXEL * (i % PIXELS_PER_BYTE))) & PIXEL_BITMASK);
+	}
+
+	windowRow++;
+	litPixelsChanged = 1;
+}
+
+void ssd1306HwFill(uint8_t first_col, uint8_t first_row, uint8_t last_col, uint8_t last_row, uint8_t pixel_value)
+{
+	for (uint8_t row = first_row; row <= last_row; row++) {
+		for (uint8_t col = first_col; col <= last_col; col++) {
+			setPixel(col, row, pixel_value);
+		}
+	}
+
+	litPixelsChanged = 1;
+}
+
+void ssd1306Flush(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS])
+{
+	/*
+		Each byte of GDDRAM holds a column of 8 screen rows, the top in bit 0, and a page is a row of such bytes.
+		With horizontal addressing, the column and page pointers move across each page of the window in turn.
+		A RENDER_SCALE above 1 is applied as each byte is built, from the frame row and column of each screen pixel.
+	*/
+	uint8_t page_bytes[FRAME_SCREEN_COLS];
+	int16_t screen_row;
+	uint8_t row;
+	uint8_t col;
+
+	uint8_t commands[6];
+
+	if (frame != NULL) {
+		ssd1306SetWindow(0, 0, FRAME_NUM_COLS - 1, FRAME_NUM_ROWS - 1);
+
+		for (row = 0; row < FRAME_NUM_ROWS; row++) {
+			ssd1306PushPixels(frame[row], FRAME_NUM_COLS);
+		}
+	}
+
+	if (!litPixelsChanged) {
+		return;
+	}
+
+	commands[0] = kSSD1306CommandCOLUMNADDR;
+	commands[1] = SCREEN_FIRST_COL;
+	commands[2] = SCREEN_FIRST_COL + FRAME_SCREEN_COLS - 1;
+	commands[3] = kSSD1306CommandPAGEADDR;
+	commands[4] = SCREEN_FIRST_PAGE;
+	commands[5] = SCREEN_LAST_PAGE;
+
+	/* Drive CS low. */
+	GPIO_DRV_ClearPinOutput(kSSD1306PinCSn);
+
+	writeCommands(commands, sizeof(commands));
+
+	/* Drive DC high (data). */
+	GPIO_DRV_SetPinOutput(kSSD1306PinDC);
+
+	for (uint8_t page = SCREEN_FIRST_PAGE; page <= SCREEN_LAST_PAGE; page++) {
+		for (uint8_t screen_col = 0; screen_col < FRAME_SCREEN_COLS; screen_col++) {
+			col = screen_col / RENDER_SCALE;
+			page_bytes[screen_col] = 0;
+
+			for (uint8_t bit = 0; bit < kSSD1306RowsPerPage; bit++) {
+				/* Screen rows above and below the frame are left black. */
+				screen_row = (page * kSSD1306RowsPerPage) + bit - SCREEN_FIRST_ROW;
+
+				if ( (screen_row < 0) || (screen_row >= FRAME_SCREEN_ROWS) ) {
+					continue;
+				}
+
+				row = screen_row / RENDER_SCALE;
+
+				if (litPixels[row][col / 8] & (1 << (col % 8))) {
+					page_bytes[screen_col] |= 1 << bit;
+				}
+			}
+		}
+
+		writeBytes(page_bytes, sizeof(page_bytes));
+	}
+
+	/* Drive CS high. */
+	GPIO_DRV_SetPinOutput(kSSD1306PinCSn);
+
+	litPixelsChanged = 0;
+}
+
+/*
+	Initialization sequence for a 128x64 panel with the internal charge pump, adapted from
+	https://github.com/adafruit/Adafruit_SSD1306. Stored in FLASH/ROM and sent as one command list.
+*/
+static const uint8_t initCommands[] =
+{
+	kSSD1306CommandDISPLAYOFF,
+	kSSD1306CommandSETDISPLAYCLOCKDIV,	0x80,
+	kSSD1306CommandSETMULTIPLEX,		kSSD1306ScreenRows - 1,
+	kSSD1306CommandSETDISPLAYOFFSET,	0x0,
+	kSSD1306CommandSETSTARTLINE | 0x0,
+	kSSD1306CommandCHARGEPUMP,		0x14,
+	kSSD1306CommandMEMORYMODE,		0x00,	/* Horizontal addressing. */
+	kSSD1306CommandSEGREMAP | 0x1,
+	kSSD1306CommandCOMSCANDEC,
+	kSSD1306CommandSETCOMPINS,		0x12,
+	kSSD1306CommandSETCONTRAST,		0xCF,
+	kSSD1306CommandSETPRECHARGE,		0xF1,
+	kSSD1306CommandSETVCOMDETECT,		0x40,
+	kSSD1306CommandDISPLAYALLONRESUME,
+	kSSD1306CommandNORMALDISPLAY,
+	kSSD1306CommandDISPLAYON,
+
+	/* End of standard initialisation sequence. Write area of the whole screen, for clearing. */
+	kSSD1306CommandCOLUMNADDR,		0, kSSD1306ScreenCols - 1,
+	kSSD1306CommandPAGEADDR,		0, (kSSD1306ScreenRows / kSSD1306RowsPerPage) - 1,
+};
+
+void devSSD1306init(void)
+{
+	uint8_t blank[kSSD1306ScreenCols];
+
+	/*
+	 *	Override Warp firmware's use of these pins.
+	 *
+	 *	Re-configure SPI to be on PTA8 and PTA9 for MOSI and SCK respectively.
+	 */
+	PORT_HAL_SetMuxMode(PORTA_BASE, 8u, kPortMuxAlt3);
+	PORT_HAL_SetMuxMode(PORTA_BASE, 9u, kPortMuxAlt3);
+
+	warpEnableSPIpins();
+
+	/*
+	 *	Override Warp firmware's use of these pins.
+	 *
+	 *	Reconfigure to use as GPIO.
+	 */
+	PORT_HAL_SetMuxMode(PORTB_BASE, 11u, kPortMuxAsGpio);
+	PORT_HAL_SetMuxMode(PORTA_BASE, 12u, kPortMuxAsGpio);
+	PORT_HAL_SetMuxMode(PORTB_BASE, 0u, kPortMuxAsGpio);
+
+	/*
+	 *	RST high->low->high.
+	 *
+	 *	The SSD1306 needs RST low for at least 3us (t1 in the datasheet). 1ms is the shortest OSA_TimeDelay().
+	 */
+	GPIO_DRV_SetPinOutput(kSSD1306PinRST);
+	OSA_TimeDelay(1);
+	GPIO_DRV_ClearPinOutput(kSSD1306PinRST);
+	OSA_TimeDelay(1);
+	GPIO_DRV_SetPinOutput(kSSD1306PinRST);
+	OSA_TimeDelay(1);
+
+	/* MEMSET not used as to avoid introduction of string.h. */
+	for (uint8_t col = 0; col < kSSD1306ScreenCols; col++) {
+		blank[col] = 0;
+	}
+
+	/*
+		Drive /CS low.
+
+		Make sure there is a high-to-low transition by first driving high.
+	*/
+	GPIO_DRV_SetPinOutput(kSSD1306PinCSn);
+	GPIO_DRV_ClearPinOutput(kSSD1306PinCSn);
+
+	writeCommands(initCommands, sizeof(initCommands));
+
+	/* Drive DC high (data). GDDRAM is not cleared by reset, so each page is cleared. */
+	GPIO_DRV_SetPinOutput(kSSD1306PinDC);
+
+	for (uint8_t page = 0; page < kSSD1306ScreenRows / kSSD1306RowsPerPage; page++) {
+		writeBytes(blank, sizeof(blank));
+	}
+
+	/* Drive /CS high. */
+	GPIO_DRV_SetPinOutput(kSSD1306PinCSn);
+}
+
+#if (DISPLAY_VTABLE)
+	const DisplayBackend ssd1306Display =
+	{
+		devSSD1306init,
+		ssd1306SetWindow,
+		ssd1306PushPixels,
+		ssd1306HwFill,
+		ssd1306Flush
+	};
+#endif
+
+#endif
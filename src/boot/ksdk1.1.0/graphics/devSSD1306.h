@@ -0,0 +1,61 @@
+/*
+ *	See https://github.com/adafruit/Adafruit_SSD1306 for the Arduino driver.
+ */
+
+#ifndef STDINT
+	#include <stdint.h>
+	#define STDINT
+#endif
+
+#ifndef GRAPHICS
+	#include "graphics.h"
+	#define GRAPHICS
+#endif
+
+typedef enum
+{
+	kSSD1306ScreenCols		= 128,
+	kSSD1306ScreenRows		= 64,
+	kSSD1306RowsPerPage		= 8,
+} SSD1306Constants;
+
+typedef enum
+{
+	kSSD1306CommandMEMORYMODE	= 0x20,
+	kSSD1306CommandCOLUMNADDR	= 0x21,
+	kSSD1306CommandPAGEADDR		= 0x22,
+	kSSD1306CommandSETSTARTLINE	= 0x40,
+	kSSD1306CommandSETCONTRAST	= 0x81,
+	kSSD1306CommandCHARGEPUMP	= 0x8D,
+	kSSD1306CommandSEGREMAP		= 0xA0,
+	kSSD1306CommandDISPLAYALLONRESUME	= 0xA4,
+	kSSD1306CommandNORMALDISPLAY	= 0xA6,
+	kSSD1306CommandSETMULTIPLEX	= 0xA8,
+	kSSD1306CommandDISPLAYOFF	= 0xAE,
+	kSSD1306CommandDISPLAYON	= 0xAF,
+	kSSD1306CommandCOMSCANDEC	= 0xC8,
+	kSSD1306CommandSETDISPLAYOFFSET	= 0xD3,
+	kSSD1306CommandSETDISPLAYCLOCKDIV	= 0xD5,
+	kSSD1306CommandSETPRECHARGE	= 0xD9,
+	kSSD1306CommandSETCOMPINS	= 0xDA,
+	kSSD1306CommandSETVCOMDETECT	= 0xDB,
+} SSD1306Commands;
+
+#if (DISPLAY_BUILT(DISPLAY_SSD1306))
+	/*
+		The display backend functions of the SSD1306, see DisplayBackend in graphics.h.
+
+		The SSD1306 holds 8 rows of 1 bit pixels per GDDRAM byte and cannot be read over SPI, so the frame is kept as
+		one bit per pixel in the MCU and drawn into by ssd1306PushPixels() and ssd1306HwFill(), as the SSD1306 has no
+		fill command. ssd1306Flush() copies a frame into it and sends it, the whole frame window, if it has changed.
+	*/
+	void devSSD1306init(void);
+	void ssd1306SetWindow(uint8_t first_col, uint8_t first_row, uint8_t last_col, uint8_t last_row);
+	void ssd1306PushPixels(const uint8_t *pixels, uint8_t num_pixels);
+	void ssd1306HwFill(uint8_t first_col, uint8_t first_row, uint8_t last_col, uint8_t last_row, uint8_t pixel_value);
+	void ssd1306Flush(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS]);
+
+	#if (DISPLAY_VTABLE)
+		extern const DisplayBackend ssd1306Display;
+	#endif
+#endif
@@ -2,13 +2,45 @@
 
 #include "fsl_spi_master_driver.h"
 #include "fsl_port_hal.h"
+#include "fsl_clock_manager.h"
 
 #include "SEGGER_RTT.h"
 #include "gpio_pins.h"
 #include "warp.h"
 #include "devSSD1331.h"
 
-volatile uint8_t	payload_bytes[2];
+/* Staging buffer for scanout, holding SCANOUT_ROWS_PER_TRANSFER screen rows in GDRAM format. */
+#if (ASYNC_SCANOUT)
+	/* Two buffers, one being sent while the other is filled. */
+	static uint8_t		scanoutBuffers[2][SCANOUT_ROWS_PER_TRANSFER * 2 * FRAME_SCREEN_COLS];
+	static volatile uint8_t	scanoutInProgress = 0;
+
+	/* Set while writeFrame() holds CS low for waitForFrame(), which may be after the last transfer has been waited for. */
+	static uint8_t		frameInProgress = 0;
+#else
+	static uint8_t		scanoutBuffer[SCANOUT_ROWS_PER_TRANSFER * 2 * FRAME_SCREEN_COLS];
+#endif
+
+#if (DIRECT_RENDERING)
+	uint32_t		directTriangles = 0;
+	static uint32_t		directSpans = 0;
+	static uint32_t		directPixels = 0;
+
+	/* Measured by printDirectBreakEven(). */
+	static uint32_t		spanNanoseconds = 0;
+	static uint32_t		pixelNanoseconds = 0;
+	static uint32_t		scanoutMicroseconds = 0;
+#endif
+
+#if (ROW_SIGNATURES)
+	/* Signature of each row of the frame as last sent. All zero matches the cleared display. */
+	static uint8_t		rowSignatures[FRAME_NUM_ROWS];
+
+	/* Row sent whatever its signature, one further down each frame, so that a row left stale by a collision is refreshed. */
+	static uint8_t		refreshRow = 0;
+	static uint32_t		rowsSent = 0;
+	static uint32_t		rowsSkipped = 0;
+#endif
 
 /*
  *	Override Warp firmware's use of these pins and define new aliases.
@@ -22,41 +54,755 @@ enum
 	kSSD1331PinRST		= GPIO_MAKE_PIN(HW_GPIOB, 0),
 };
 
-static int writeCommand(uint8_t commandByte)
+#if (ASYNC_SCANOUT)
+	/* Waits for the transfer of the previous staging buffer to complete. CS is left low. */
+	static void waitForScanoutTransfer(void)
+	{
+		if (!scanoutInProgress) {
+			return;
+		}
+
+		while (SPI_DRV_MasterGetTransferStatus(0, NULL) == kStatus_SPI_Busy) {
+			/* The SPI interrupt sends the remaining bytes. */
+		}
+
+		scanoutInProgress = 0;
+	}
+#endif
+
+void waitForFrame(void)
+{
+	#if (ASYNC_SCANOUT)
+		if (!frameInProgress) {
+			return;
+		}
+
+		waitForScanoutTransfer();
+
+		/* Drive CS high to complete frame writing interaction, deferred from writeFrame(). */
+		GPIO_DRV_SetPinOutput(kSSD1331PinCSn);
+
+		frameInProgress = 0;
+	#endif
+}
+
+#if (REGISTER_LEVEL_SPI)
+	/*
+		Sends bytes[i & index_mask] for i from 0 to num_bytes - 1 through the SPI0 registers.
+
+		The transmit buffer is kept full while the previous byte is shifted out, so bytes are sent back to back.
+		Each received byte is read as soon as the following byte is queued, well before the next could overrun it.
+		That also gives the end of the last byte, after which CS and DC may be changed.
+	*/
+	static void pushRepeatedBytes(const uint8_t *bytes, uint16_t num_bytes, uint16_t index_mask)
+	{
+		if (num_bytes == 0) {
+			return;
+		}
+
+		/* A byte left unread would be mistaken for that of the first byte sent. */
+		if (HW_SPI_S_RD(SPI0_BASE) & BM_SPI_S_SPRF) {
+			(void) HW_SPI_D_RD(SPI0_BASE);
+		}
+
+		/* The S register must be read with SPTEF set before D is written, or the write is ignored. */
+		while (!(HW_SPI_S_RD(SPI0_BASE) & BM_SPI_S_SPTEF)) {}
+		HW_SPI_D_WR(SPI0_BASE, bytes[0]);
+
+		for (uint16_t i = 1; i < num_bytes; i++) {
+			while (!(HW_SPI_S_RD(SPI0_BASE) & BM_SPI_S_SPTEF)) {}
+			HW_SPI_D_WR(SPI0_BASE, bytes[i & index_mask]);
+
+			/* Byte i - 1 has been shifted out. */
+			while (!(HW_SPI_S_RD(SPI0_BASE) & BM_SPI_S_SPRF)) {}
+			(void) HW_SPI_D_RD(SPI0_BASE);
+		}
+
+		/* The last byte has been shifted out. */
+		while (!(HW_SPI_S_RD(SPI0_BASE) & BM_SPI_S_SPRF)) {}
+		(void) HW_SPI_D_RD(SPI0_BASE);
+	}
+
+	void pushBytes(const uint8_t *bytes, uint16_t num_bytes)
+	{
+		pushRepeatedBytes(bytes, num_bytes, 0xFFFF);
+	}
+
+	void pushPixelRun(uint16_t colour, uint16_t num_pixels)
+	{
+		uint8_t pixel[2];
+
+		pixel[0] = colour >> 8;		/* MSB. */
+		pixel[1] = colour & 0xFF;	/* LSB. */
+
+		pushRepeatedBytes(pixel, 2 * num_pixels, 1);
+	}
+#endif
+
+/*
+	Sends bytes over SPI, returning once they have all been sent. CS and DC must already be driven.
+	With asynchronous scanout, no transfer may still be in progress.
+*/
+static spi_status_t writeBytes(const uint8_t *bytes, uint16_t num_bytes)
+{
+	#if (REGISTER_LEVEL_SPI)
+
+		pushBytes(bytes, num_bytes);
+
+		return kStatus_SPI_Success;
+
+	#else
+
+		return SPI_DRV_MasterTransferBlocking(
+				0,			/* Master instance. */
+				NULL		/* spi_master_user_config_t */,
+				(const uint8_t * restrict) bytes,
+				NULL,
+				num_bytes	/* Transfer size in bytes */,
+				1000		/* Timeout in microseconds (unlike I2C which is ms) */);
+
+	#endif
+}
+
+#if (DIRTY_RECTANGLES) && (INTERLACED)
+	/* Bounding box of what was drawn in the previous frame to send each field, which is still on the display. */
+	static DirtyRect	previousDirtyRects[2] = {{FRAME_NUM_ROWS, 0, FRAME_NUM_COLS, 0}, {FRAME_NUM_ROWS, 0, FRAME_NUM_COLS, 0}};
+#elif (DIRTY_RECTANGLES)
+	/* Bounding box of what was drawn in the previous frame, which is still on the display. */
+	static DirtyRect	previousDirtyRect = {FRAME_NUM_ROWS, 0, FRAME_NUM_COLS, 0};
+#endif
+
+#if (DIRTY_RECTANGLES)
+	/* Grows rect to also cover other. */
+	static void mergeDirtyRects(DirtyRect *rect, const DirtyRect *other)
+	{
+		if (other->first_row > other->last_row) {
+			return;
+		}
+
+		if (rect->first_row > rect->last_row) {
+			*rect = *other;
+			return;
+		}
+
+		if (other->first_row < rect->first_row) {
+			rect->first_row = other->first_row;
+		}
+
+		if (other->last_row > rect->last_row) {
+			rect->last_row = other->last_row;
+		}
+
+		if (other->first_col < rect->first_col) {
+			rect->first_col = other->first_col;
+		}
+
+		if (other->last_col > rect->last_col) {
+			rect->last_col = other->last_col;
+		}
+	}
+#endif
+
+/*
+	First display column and row of a frame column and (C style) frame row, and the last, which differ with a
+	RENDER_SCALE above 1. The frame is centred on the display.
+*/
+#define SCREEN_COL(col)		((SCREEN_MAX_COLS / 2) - (FRAME_SCREEN_COLS / 2) + (RENDER_SCALE * (col)))
+#define SCREEN_ROW(row)		((SCREEN_MAX_ROWS / 2) - (FRAME_SCREEN_ROWS / 2) + (RENDER_SCALE * (row)))
+#define SCREEN_COL_END(col)	(SCREEN_COL(col) + RENDER_SCALE - 1)
+#define SCREEN_ROW_END(row)	(SCREEN_ROW(row) + RENDER_SCALE - 1)
+
+/*
+	With row signatures, run-length scanout or interlacing, rows (or parts of rows) are left out of the data stream
+	sent by writeFrame(), so the write area must be set again before the data that follows them.
+*/
+#define SCANOUT_REWINDOWS ((ROW_SIGNATURES) || (RLE_SCANOUT) || (INTERLACED))
+
+/* Sends a command, or a list of commands, with their arguments in one transfer. CS must already be driven low. */
+static spi_status_t writeCommands(const uint8_t *commands, uint8_t num_bytes)
+{
+	/* Drive DC low (command). */
+	GPIO_DRV_ClearPinOutput(kSSD1331PinDC);
+
+	return writeBytes(commands, num_bytes);
+}
+
+int writeCommandList(const uint8_t *commands, uint8_t num_bytes)
 {
 	spi_status_t status;
 
+	/* A frame may still be being sent. */
+	waitForFrame();
+
 	/*
-	 *	Drive /CS low.
-	 *
-	 *	Make sure there is a high-to-low transition by first driving high, delay, then drive low.
-	 */
+		Drive /CS low.
+
+		Make sure there is a high-to-low transition by first driving high. The SSD1331 only needs /CS high for
+		tens of nanoseconds (tCSH in the datasheet), far less than the time between the two calls.
+	*/
 	GPIO_DRV_SetPinOutput(kSSD1331PinCSn);
-	OSA_TimeDelay(10);
 	GPIO_DRV_ClearPinOutput(kSSD1331PinCSn);
 
+	status = writeCommands(commands, num_bytes);
+
+	/* Drive /CS high. */
+	GPIO_DRV_SetPinOutput(kSSD1331PinCSn);
+
+	return status;
+}
+
+#if (DIRTY_RECTANGLES) || (SCANOUT_REWINDOWS) || (DIRECT_RENDERING) || (DISPLAY_BUILT(DISPLAY_SSD1331))
 	/*
-	 *	Drive DC low (command).
-	 */
-	GPIO_DRV_ClearPinOutput(kSSD1331PinDC);
+		Sets the write area of GDRAM to the given frame columns and rows, inclusive, and resets the GDRAM pointers
+		to its top left. CS must already be driven low. The six command bytes are sent in one transfer.
+	*/
+	static void setWriteWindow(uint8_t first_col, uint8_t first_row, uint8_t last_col, uint8_t last_row)
+	{
+		uint8_t commands[6];
+
+		commands[0] = kSSD1331CommandSETCOLUMN;
+		commands[1] = SCREEN_COL(first_col);
+		commands[2] = SCREEN_COL_END(last_col);
+		commands[3] = kSSD1331CommandSETROW;
+		commands[4] = SCREEN_ROW(first_row);
+		commands[5] = SCREEN_ROW_END(last_row);
 
-	payload_bytes[0] = commandByte;
-	status = SPI_DRV_MasterTransferBlocking(
-					0,			/* Master instance. */
-					NULL		/* spi_master_user_config_t */,
-					(const uint8_t * restrict) &payload_bytes[0],
-					NULL,
-					1			/* Transfer size */,
-					1000		/* Timeout in microseconds (unlike I2C which is ms) */);
+		writeCommands(commands, sizeof(commands));
+	}
+#endif
 
+#if (HW_PRIMITIVES) || (RLE_SCANOUT) || (DIRECT_HW_SPANS) || (DISPLAY_BUILT(DISPLAY_SSD1331))
 	/*
-	 *	Drive /CS high
-	 */
-	GPIO_DRV_SetPinOutput(kSSD1331PinCSn);
+		Splits the 16 bit GDRAM colour of a pixel value into the three 6 bit colour arguments of DRAWLINE and DRAWRECT,
+		sent in the order C, B, A. That is, from the most significant end of the GDRAM colour.
+	*/
+	static void setDrawColour(uint8_t colour[3], uint8_t pixel_value)
+	{
+		uint16_t gdram_colour = pixelValueToColour(pixel_value);
 
-	return status;
+		colour[0] = (gdram_colour >> 11) << 1;
+		colour[1] = (gdram_colour >> 5) & 0x3F;
+		colour[2] = (gdram_colour << 1) & 0x3F;
+	}
+#endif
+
+#if (ROW_SIGNATURES)
+	/* CRC-8 (polynomial 0x07) of each byte value. Stored in FLASH/ROM. */
+	static const uint8_t crc8Lookup[256] =
+	{
+		0,7,14,9,28,27,18,21,56,63,54,49,36,35,42,45,
+		112,119,126,121,108,107,98,101,72,79,70,65,84,83,90,93,
+		224,231,238,233,252,251,242,245,216,223,214,209,196,195,202,205,
+		144,151,158,153,140,139,130,133,168,175,166,161,180,179,186,189,
+		199,192,201,206,219,220,213,210,255,248,241,246,227,228,237,234,
+		183,176,185,190,171,172,165,162,143,136,129,134,147,148,157,154,
+		39,32,41,46,59,60,53,50,31,24,17,22,3,4,13,10,
+		87,80,89,94,75,76,69,66,111,104,97,102,115,116,125,122,
+		137,142,135,128,149,146,155,156,177,182,191,184,173,170,163,164,
+		249,254,247,240,229,226,235,236,193,198,207,200,221,218,211,212,
+		105,110,103,96,117,114,123,124,81,86,95,88,77,74,67,68,
+		25,30,23,16,5,2,11,12,33,38,47,40,61,58,51,52,
+		78,73,64,71,82,85,92,91,118,113,120,127,106,109,100,99,
+		62,57,48,55,34,37,44,43,6,1,8,15,26,29,20,19,
+		174,169,160,167,178,181,188,187,150,145,152,159,138,141,132,131,
+		222,217,208,215,194,197,204,203,230,225,232,239,250,253,244,243
+	};
+
+	/* CRC-8 signature of a row of the frame. A blank row has signature 0. */
+	static uint8_t rowSignature(const uint8_t row[FRAME_TRUE_COLS])
+	{
+		uint8_t signature = 0;
+
+		for (uint8_t col = 0; col < FRAME_TRUE_COLS; col++) {
+			signature = crc8Lookup[signature ^ row[col]];
+		}
+
+		return signature;
+	}
+
+	void printScanoutRowCounts(uint32_t num_frames)
+	{
+		/* Division can be truncated safely. */
+		warpPrint("Rows sent per frame: %d, rows skipped per frame: %d.\n", rowsSent / num_frames, rowsSkipped / num_frames);
+
+		rowsSent = 0;
+		rowsSkipped = 0;
+	}
+#endif
+
+/*
+	Sends the rows staged from 'staging' up to 'staged'. Returns the staging buffer to fill next,
+	which with asynchronous scanout is the other buffer.
+*/
+static uint8_t *sendStagedRows(uint8_t *staging, uint8_t *staged)
+{
+	#if (ASYNC_SCANOUT)
+
+		/* The other buffer must have been sent before this one can be. */
+		waitForScanoutTransfer();
+
+		SPI_DRV_MasterTransfer(
+			0,			/* Master instance. */
+			NULL		/* spi_master_user_config_t */,
+			(const uint8_t * restrict) staging,
+			NULL,
+			staged - staging	/* Transfer size in bytes */);
+
+		scanoutInProgress = 1;
+
+		/* Fill the other buffer while this one is sent. */
+		return (staging == scanoutBuffers[0]) ? scanoutBuffers[1] : scanoutBuffers[0];
+
+	#else
+
+		writeBytes(staging, staged - staging);
+
+		return staging;
+
+	#endif
+}
+
+#if (HW_PRIMITIVES) || (DIRECT_RENDERING)
+	/*
+		Sends a whole command, with its arguments, in one transfer and then waits delay_milliseconds for the
+		SSD1331 to draw it.
+	*/
+	static void writeDrawCommand(const uint8_t *commands, uint8_t num_bytes, uint32_t delay_milliseconds)
+	{
+		writeCommandList(commands, num_bytes);
+
+		OSA_TimeDelay(delay_milliseconds);
+	}
+
+	void hwClearFrame(void)
+	{
+		uint8_t commands[5];
+
+		commands[0] = kSSD1331CommandCLEAR;
+		commands[1] = SCREEN_COL(0);
+		commands[2] = SCREEN_ROW(0);
+		commands[3] = SCREEN_COL_END(FRAME_NUM_COLS - 1);
+		commands[4] = SCREEN_ROW_END(FRAME_NUM_ROWS - 1);
+
+		writeDrawCommand(commands, sizeof(commands), kSSD1331DelaysHWFILL);
+	}
+#endif
+
+#if (HW_PRIMITIVES)
+	void hwDrawLine(const uint8_t point_0[2], const uint8_t point_1[2], uint8_t pixel_value)
+	{
+		uint8_t commands[8];
+
+		commands[0] = kSSD1331CommandDRAWLINE;
+		commands[1] = SCREEN_COL(point_0[X]);
+		commands[2] = SCREEN_ROW(FRAME_ROW(point_0[Y]));
+		commands[3] = SCREEN_COL(point_1[X]);
+		commands[4] = SCREEN_ROW(FRAME_ROW(point_1[Y]));
+		setDrawColour(&commands[5], pixel_value);
+
+		writeDrawCommand(commands, sizeof(commands), kSSD1331DelaysHWLINE);
+	}
+
+	void hwFillRect(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t pixel_value)
+	{
+		uint8_t commands[11];
+
+		/* DRAWRECT expects the top left corner first. */
+		commands[0] = kSSD1331CommandDRAWRECT;
+		commands[1] = SCREEN_COL( (x0 < x1) ? x0 : x1 );
+		commands[2] = SCREEN_ROW(FRAME_ROW( (y0 > y1) ? y0 : y1 ));
+		commands[3] = SCREEN_COL( (x0 < x1) ? x1 : x0 );
+		commands[4] = SCREEN_ROW(FRAME_ROW( (y0 > y1) ? y1 : y0 ));
+
+		/* Outline and fill the same colour. */
+		setDrawColour(&commands[5], pixel_value);
+		setDrawColour(&commands[8], pixel_value);
+
+		writeDrawCommand(commands, sizeof(commands), kSSD1331DelaysHWFILL);
+	}
+#endif
+
+/*
+	Calculates the 16 bit GDRAM colour of a 4 bit pixel value. This is simply the colour and the ratio of
+	the distance to the maximum distance mapped to the minimum and maximum intensity. The result is left shifted
+	as appropriate such that the correct colour is displayed.
+
+	If either colour or intensity is zero, the pixel is black (pixel off).
+
+	This is only ever evaluated by the compiler to build the tables below, such that no float arithmetic
+	is left in scanout, and the tables always agree with the intensity constants in graphics.h.
+*/
+#define COLOUR_LEFT_SHIFT(colour) \
+	( (colour) == R ? RED_LEFT_SHIFT : ( (colour) == G ? GREEN_LEFT_SHIFT : BLUE_LEFT_SHIFT ) )
+
+#define PIXEL_VALUE_COLOUR(pixel_value) \
+	( ( ((pixel_value) & COLOUR_BITMASK) && ((pixel_value) & RELATIVE_INTENSITY_BITMASK) ) ? \
+		(uint16_t) ( ( (uint8_t) (MAX_COLOUR_INTENSITY_FLOAT * (RELATIVE_INTENSITY_FROM_PIXEL_VALUE(pixel_value) / MAX_RELATIVE_INTENSITY_FLOAT)) ) \
+			<< COLOUR_LEFT_SHIFT(COLOUR_FROM_PIXEL_VALUE(pixel_value)) ) \
+		: 0 )
+
+/* 16 bit GDRAM colour of each 4 bit pixel value. Stored in FLASH/ROM. */
+static const uint16_t pixelValueColours[1 << BITS_PER_PIXEL] =
+{
+	PIXEL_VALUE_COLOUR(0), PIXEL_VALUE_COLOUR(1), PIXEL_VALUE_COLOUR(2), PIXEL_VALUE_COLOUR(3),
+	PIXEL_VALUE_COLOUR(4), PIXEL_VALUE_COLOUR(5), PIXEL_VALUE_COLOUR(6), PIXEL_VALUE_COLOUR(7),
+	PIXEL_VALUE_COLOUR(8), PIXEL_VALUE_COLOUR(9), PIXEL_VALUE_COLOUR(10), PIXEL_VALUE_COLOUR(11),
+	PIXEL_VALUE_COLOUR(12), PIXEL_VALUE_COLOUR(13), PIXEL_VALUE_COLOUR(14), PIXEL_VALUE_COLOUR(15)
+};
+
+/*
+	The GDRAM data stream for a whole frame byte, that is the two pixels it holds. The even (lower nibble)
+	pixel is sent first and each colour is sent MSB first. Stored in FLASH/ROM, 1 KB.
+*/
+#define PIXEL_PAIR_BYTES(frame_byte) \
+	{ \
+		PIXEL_VALUE_COLOUR((frame_byte) & PIXEL_BITMASK) >> 8, \
+		PIXEL_VALUE_COLOUR((frame_byte) & PIXEL_BITMASK) & 0xFF, \
+		PIXEL_VALUE_COLOUR((frame_byte) >> BITS_PER_PIXEL) >> 8, \
+		PIXEL_VALUE_COLOUR((frame_byte) >> BITS_PER_PIXEL) & 0xFF \
+	}
+
+#define PIXEL_PAIR_BYTES_ROW(upper_pixel_value) \
+	PIXEL_PAIR_BYTES(16 * (upper_pixel_value) + 0), PIXEL_PAIR_BYTES(16 * (upper_pixel_value) + 1), \
+	PIXEL_PAIR_BYTES(16 * (upper_pixel_value) + 2), PIXEL_PAIR_BYTES(16 * (upper_pixel_value) + 3), \
+	PIXEL_PAIR_BYTES(16 * (upper_pixel_value) + 4), PIXEL_PAIR_BYTES(16 * (upper_pixel_value) + 5), \
+	PIXEL_PAIR_BYTES(16 * (upper_pixel_value) + 6), PIXEL_PAIR_BYTES(16 * (upper_pixel_value) + 7), \
+	PIXEL_PAIR_BYTES(16 * (upper_pixel_value) + 8), PIXEL_PAIR_BYTES(16 * (upper_pixel_value) + 9), \
+	PIXEL_PAIR_BYTES(16 * (upper_pixel_value) + 10), PIXEL_PAIR_BYTES(16 * (upper_pixel_value) + 11), \
+	PIXEL_PAIR_BYTES(16 * (upper_pixel_value) + 12), PIXEL_PAIR_BYTES(16 * (upper_pixel_value) + 13), \
+	PIXEL_PAIR_BYTES(16 * (upper_pixel_value) + 14), PIXEL_PAIR_BYTES(16 * (upper_pixel_value) + 15)
+
+static const uint8_t pixelPairBytes[1 << (PIXELS_PER_BYTE * BITS_PER_PIXEL)][2 * PIXELS_PER_BYTE] =
+{
+	PIXEL_PAIR_BYTES_ROW(0), PIXEL_PAIR_BYTES_ROW(1), PIXEL_PAIR_BYTES_ROW(2), PIXEL_PAIR_BYTES_ROW(3),
+	PIXEL_PAIR_BYTES_ROW(4), PIXEL_PAIR_BYTES_ROW(5), PIXEL_PAIR_BYTES_ROW(6), PIXEL_PAIR_BYTES_ROW(7),
+	PIXEL_PAIR_BYTES_ROW(8), PIXEL_PAIR_BYTES_ROW(9), PIXEL_PAIR_BYTES_ROW(10), PIXEL_PAIR_BYTES_ROW(11),
+	PIXEL_PAIR_BYTES_ROW(12), PIXEL_PAIR_BYTES_ROW(13), PIXEL_PAIR_BYTES_ROW(14), PIXEL_PAIR_BYTES_ROW(15)
+};
+
+uint16_t pixelValueToColour(uint8_t pixel_value)
+{
+	return pixelValueColours[pixel_value & PIXEL_BITMASK];
+}
+
+/*
+	Converts the frame bytes first_byte to last_byte of a row into the GDRAM datastream at staged, that of one screen
+	row. Returns its end.
+*/
+static uint8_t *stageRow(uint8_t *staged, const uint8_t row[FRAME_TRUE_COLS], uint8_t first_byte, uint8_t last_byte)
+{
+	const uint8_t *pixel_pair;
+
+	for (uint8_t col = first_byte; col <= last_byte; col++) {
+		/* One table lookup per two pixels. */
+		pixel_pair = pixelPairBytes[row[col]];
+
+		#if (RENDER_SCALE == 1)
+			*staged++ = pixel_pair[0];
+			*staged++ = pixel_pair[1];
+			*staged++ = pixel_pair[2];
+			*staged++ = pixel_pair[3];
+		#else
+			/* Each pixel is sent for RENDER_SCALE columns of the screen. */
+			for (uint8_t i = 0; i < RENDER_SCALE; i++) {
+				*staged++ = pixel_pair[0];
+				*staged++ = pixel_pair[1];
+			}
+
+			for (uint8_t i = 0; i < RENDER_SCALE; i++) {
+				*staged++ = pixel_pair[2];
+				*staged++ = pixel_pair[3];
+			}
+		#endif
+	}
+
+	return staged;
 }
 
+#if (RENDER_SCALE > 1)
+	/*
+		Copies the screen row of num_bytes at screen_row to staged, unless it is already there, and returns the end
+		of the staged data. Screen rows are staged at multiples of their size, so the two never partly overlap.
+	*/
+	static uint8_t *repeatStagedRow(uint8_t *staged, const uint8_t *screen_row, uint8_t num_bytes)
+	{
+		if (staged != screen_row) {
+			for (uint8_t i = 0; i < num_bytes; i++) {
+				staged[i] = screen_row[i];
+			}
+		}
+
+		return staged + num_bytes;
+	}
+#endif
+
+#if (RLE_SCANOUT)
+	/*
+		Finds the first run of at least RLE_MIN_RUN identical pixels in frame bytes from_byte to last_byte of a row.
+		Returns the first byte of the run and sets run_end to its last, or returns last_byte + 1 if there is none.
+	*/
+	static uint8_t findRun(const uint8_t row[FRAME_TRUE_COLS], uint8_t from_byte, uint8_t last_byte, uint8_t *run_end)
+	{
+		uint8_t end;
+
+		for (uint8_t col = from_byte; col <= last_byte; col = end + 1) {
+			end = col;
+
+			while ( (end < last_byte) && (row[end + 1] == row[col]) ) {
+				end++;
+			}
+
+			/* Both pixels of the bytes must be the same. */
+			if ( ((row[col] & PIXEL_BITMASK) == (row[col] >> BITS_PER_PIXEL)) &&
+				(PIXELS_PER_BYTE * (end - col + 1) >= RLE_MIN_RUN) ) {
+				*run_end = end;
+				return col;
+			}
+		}
+
+		return last_byte + 1;
+	}
+
+	/* Fills frame bytes first_byte to last_byte of a (C style) frame row with a pixel value. CS must already be driven low. */
+	static void fillRun(uint8_t frame_row, uint8_t first_byte, uint8_t last_byte, uint8_t pixel_value)
+	{
+		uint8_t commands[11];
+
+		commands[1] = SCREEN_COL(first_byte * PIXELS_PER_BYTE);
+		commands[2] = SCREEN_ROW(frame_row);
+		commands[3] = SCREEN_COL_END( (last_byte * PIXELS_PER_BYTE) + 1 );
+		commands[4] = SCREEN_ROW_END(frame_row);
+
+		if (pixel_value == 0) {
+			commands[0] = kSSD1331CommandCLEAR;
+			writeCommands(commands, 5);
+
+		} else {
+			/* Outline and fill the same colour. */
+			commands[0] = kSSD1331CommandDRAWRECT;
+			setDrawColour(&commands[5], pixel_value);
+			setDrawColour(&commands[8], pixel_value);
+			writeCommands(commands, sizeof(commands));
+		}
+
+		#if (RLE_FILL_DELAY_MILLISECONDS)
+			OSA_TimeDelay(RLE_FILL_DELAY_MILLISECONDS);
+		#endif
+	}
+
+	/*
+		Sends frame bytes first_byte to last_byte of a (C style) frame row through a write area of their own.
+		CS must already be driven low.
+	*/
+	static void writeRowSegment(
+		uint8_t *staging,
+		const uint8_t row[FRAME_TRUE_COLS],
+		uint8_t frame_row,
+		uint8_t first_byte,
+		uint8_t last_byte
+	)
+	{
+		uint8_t *staged;
+
+		setWriteWindow(first_byte * PIXELS_PER_BYTE, frame_row, (last_byte * PIXELS_PER_BYTE) + 1, frame_row);
+
+		/* Drive DC high (data). */
+		GPIO_DRV_SetPinOutput(kSSD1331PinDC);
+
+		staged = stageRow(staging, row, first_byte, last_byte);
+
+		/* The frame row covers RENDER_SCALE rows of the write area. */
+		for (uint8_t repeat = 0; repeat < RENDER_SCALE; repeat++) {
+			writeBytes(staging, staged - staging);
+		}
+	}
+
+	/*
+		Sends frame bytes first_byte to last_byte of a (C style) frame row, the first run of which has already been
+		found by findRun(). Runs are filled and the parts between them are sent as data.
+	*/
+	static void writeRowRuns(
+		uint8_t *staging,
+		const uint8_t row[FRAME_TRUE_COLS],
+		uint8_t frame_row,
+		uint8_t first_byte,
+		uint8_t last_byte,
+		uint8_t run_start,
+		uint8_t run_end
+	)
+	{
+		uint8_t segment_start = first_byte;
+
+		while (run_start <= last_byte) {
+			if (segment_start < run_start) {
+				writeRowSegment(staging, row, frame_row, segment_start, run_start - 1);
+			}
+
+			fillRun(frame_row, run_start, run_end, row[run_start] & PIXEL_BITMASK);
+
+			segment_start = run_end + 1;
+			run_start = findRun(row, segment_start, last_byte, &run_end);
+		}
+
+		if (segment_start <= last_byte) {
+			writeRowSegment(staging, row, frame_row, segment_start, last_byte);
+		}
+	}
+
+	void printRleBreakEven(void)
+	{
+		/*
+			A run of n pixels in the middle of a row replaces 2n data bytes with a fill and the write area of the
+			data after it. Each is repeated RLE_BREAK_EVEN_REPEATS times: a fill, a one byte (two pixel) data write
+			in its own write area and a whole row data write in its own write area. The latter two give the time
+			per pixel and the fixed time of a data write, from which the break-even length follows.
+		*/
+		#define RLE_BREAK_EVEN_REPEATS 1000
+
+		uint8_t row[FRAME_TRUE_COLS];
+		uint32_t start_milliseconds;
+		uint32_t fill_milliseconds;
+		uint32_t short_milliseconds;
+		uint32_t long_milliseconds;
+
+		#if (ASYNC_SCANOUT)
+			uint8_t *staging = scanoutBuffers[0];
+		#else
+			uint8_t *staging = scanoutBuffer;
+		#endif
+
+		/* MEMSET not used as to avoid introduction of string.h. */
+		for (uint8_t col = 0; col < FRAME_TRUE_COLS; col++) {
+			row[col] = 0;
+		}
+
+		waitForFrame();
+
+		/* Drive CS low. */
+		GPIO_DRV_ClearPinOutput(kSSD1331PinCSn);
+
+		/* DRAWRECT, the longer of the two fill commands. */
+		start_milliseconds = OSA_TimeGetMsec();
+		for (uint16_t i = 0; i < RLE_BREAK_EVEN_REPEATS; i++) {
+			fillRun(0, 0, FRAME_TRUE_COLS - 1, R + (MAX_RELATIVE_INTENSITY << PIXELS_PER_BYTE));
+		}
+		fill_milliseconds = OSA_TimeGetMsec() - start_milliseconds;
+
+		start_milliseconds = OSA_TimeGetMsec();
+		for (uint16_t i = 0; i < RLE_BREAK_EVEN_REPEATS; i++) {
+			writeRowSegment(staging, row, 0, 0, 0);
+		}
+		short_milliseconds = OSA_TimeGetMsec() - start_milliseconds;
+
+		start_milliseconds = OSA_TimeGetMsec();
+		for (uint16_t i = 0; i < RLE_BREAK_EVEN_REPEATS; i++) {
+			writeRowSegment(staging, row, 0, 0, FRAME_TRUE_COLS - 1);
+		}
+		long_milliseconds = OSA_TimeGetMsec() - start_milliseconds;
+
+		warpPrint("%d fills: %dms, two pixel writes: %dms, %d pixel writes: %dms.\n",
+			RLE_BREAK_EVEN_REPEATS, fill_milliseconds, short_milliseconds, FRAME_NUM_COLS, long_milliseconds);
+
+		if (long_milliseconds > short_milliseconds) {
+			/* n pixels of data cost the fill plus a data write of no pixels. Division can be truncated safely. */
+			warpPrint("Run-length break-even: %d pixels.\n",
+				( (fill_milliseconds + short_milliseconds) * (FRAME_NUM_COLS - PIXELS_PER_BYTE) / (long_milliseconds - short_milliseconds) ) - PIXELS_PER_BYTE);
+		}
+
+		/* Leave the frame window as cleared by devSSD1331init(). */
+		for (uint8_t frame_row = 0; frame_row < FRAME_NUM_ROWS; frame_row++) {
+			fillRun(frame_row, 0, FRAME_TRUE_COLS - 1, 0);
+		}
+
+		/* Drive CS high. */
+		GPIO_DRV_SetPinOutput(kSSD1331PinCSn);
+
+		OSA_TimeDelay(kSSD1331DelaysHWFILL);
+	}
+#endif
+
+#if (DIRECT_RENDERING)
+	void directDrawSpan(uint8_t y, uint8_t x0, uint8_t x1, uint8_t pixel_value)
+	{
+		uint8_t frame_row;
+
+		#if (DIRECT_HW_SPANS)
+			uint8_t commands[11];
+		#elif !(REGISTER_LEVEL_SPI)
+			#if (ASYNC_SCANOUT)
+				uint8_t *staging = scanoutBuffers[0];
+			#else
+				uint8_t *staging = scanoutBuffer;
+			#endif
+
+			uint8_t *staged = staging;
+			uint16_t colour;
+		#endif
+
+		if (y >= FRAME_NUM_ROWS) {
+			return;
+		}
+
+		if (x1 >= FRAME_NUM_COLS) {
+			x1 = FRAME_NUM_COLS - 1;
+		}
+
+		if (x0 > x1) {
+			return;
+		}
+
+		frame_row = FRAME_ROW(y);
+
+		directSpans++;
+		directPixels += x1 - x0 + 1;
+
+		/* Drive CS low. */
+		GPIO_DRV_ClearPinOutput(kSSD1331PinCSn);
+
+		#if (DIRECT_HW_SPANS)
+
+			/* Outline and fill the same colour. */
+			commands[0] = kSSD1331CommandDRAWRECT;
+			commands[1] = SCREEN_COL(x0);
+			commands[2] = SCREEN_ROW(frame_row);
+			commands[3] = SCREEN_COL_END(x1);
+			commands[4] = SCREEN_ROW_END(frame_row);
+			setDrawColour(&commands[5], pixel_value);
+			setDrawColour(&commands[8], pixel_value);
+
+			writeCommands(commands, sizeof(commands));
+
+		#else
+
+			setWriteWindow(x0, frame_row, x1, frame_row);
+
+			/* Drive DC high (data). */
+			GPIO_DRV_SetPinOutput(kSSD1331PinDC);
+
+			#if (REGISTER_LEVEL_SPI)
+				/* The write area holds RENDER_SCALE x RENDER_SCALE screen pixels per frame pixel. */
+				pushPixelRun(pixelValueToColour(pixel_value), RENDER_SCALE * RENDER_SCALE * (x1 - x0 + 1));
+			#else
+				colour = pixelValueToColour(pixel_value);
+
+				/* One screen row of the span is staged, then sent for each of the RENDER_SCALE rows of the write area. */
+				for (uint8_t x = 0; x < RENDER_SCALE * (x1 - x0 + 1); x++) {
+					*staged++ = colour >> 8;	/* MSB. */
+					*staged++ = colour & 0xFF;	/* LSB. */
+				}
+
+				for (uint8_t repeat = 0; repeat < RENDER_SCALE; repeat++) {
+					writeBytes(staging, staged - staging);
+				}
+			#endif
+
+		#endif
+
+		/* Drive CS high. */
+		GPIO_DRV_SetPinOutput(kSSD1331PinCSn);
+	}
+#endif
+
 /*
 	With a frame fully drawn in the 'frame' array, we now write it to the Graphics Display RAM
 	(GDRAM) within the chip over an SPI interface. Please see the SSD1331 datasheet for more information.
@@ -77,68 +823,613 @@ void writeFrame(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS])
 
 		B_4, B_3, B_2, B_1, B_0, G_5, G_4, G_3, G_2, G_1, G_0, R_4, R_3, R_2, R_1, R_0
 
-		Bitmasking is used below to extract and compute the final colour from the 8 bits representing each pixel.
-	*/
+		Each byte of the frame holds two pixels. Rather than extracting and computing the colour of each pixel,
+		the byte indexes pixelPairBytes, which holds the four bytes of the datastream for both pixels.
 
-	uint16_t payload;
-	uint8_t pixel_value; /* Contains both colour and 'distance'. */
+		The driver's setup, status polling and timeout handling cost far more than sending a few bytes, so the
+		datastream of SCANOUT_ROWS_PER_TRANSFER rows is staged in scanoutBuffer and sent in one transfer.
 
-	/*
-		Stores the amounts by which to left shift each colour such that it is displayed appropriately. This
-		array is iterated over as necessary later (hence not an enum). FRAME_NUM_COLOURS + 1 is used to account for black (no colour).
+		With asynchronous scanout, two staging buffers are used in turn. Each is sent by the SPI interrupt while the
+		next is filled, and the function returns while the last is still being sent. waitForFrame() must be called
+		before anything else is sent to the display, which the functions of this driver do themselves.
+
+		With dirty rectangles, the write area is first set to the window of the frame that has changed and only that
+		window is sent.
+
+		With banded rendering, 'frame' only holds the current band. The bands are written in order from the top of
+		the frame, so the GDRAM pointers continue from the end of one band to the start of the next and wrap back
+		to the top left of the write area after the last band. Hence the same write area serves every band.
+
+		With row signatures, rows that have not changed since they were last sent are skipped. The write area is
+		set again, from the next row sent to the last row, whenever rows have been skipped before it. One row,
+		refreshRow, is sent whether or not it has changed, in case a change was missed by a signature collision.
+
+		With run-length scanout, rows holding a run of at least RLE_MIN_RUN identical pixels are drawn part by
+		part by writeRowRuns(), after which the write area is also set again.
+
+		With interlacing, rows outside of frame_field are skipped as are unchanged rows with row signatures. Their
+		signatures are left as they are, as GDRAM still holds those rows as last sent.
+
+		With a RENDER_SCALE above 1, each pixel is staged RENDER_SCALE times over and each row, so staged, is sent
+		RENDER_SCALE times over. Repeats are copied within the staging buffers, or sent again from where they are.
 	*/
-	uint8_t shifts[FRAME_NUM_COLOURS + 1];
 
-	shifts[K] = 0;
-	shifts[R] = RED_LEFT_SHIFT;
-	shifts[G] = GREEN_LEFT_SHIFT;
-	shifts[B] = BLUE_LEFT_SHIFT;
+	uint8_t first_row = 0;
+	uint8_t last_row = FRAME_TRUE_ROWS - 1;
+	uint8_t first_byte = 0;
+	uint8_t last_byte = FRAME_TRUE_COLS - 1;
+	uint8_t rows_staged = 0;
+
+	#if (ASYNC_SCANOUT)
+		uint8_t *staging = scanoutBuffers[0];
+	#else
+		uint8_t *staging = scanoutBuffer;
+	#endif
+
+	uint8_t *staged = staging;
+
+	#if (DIRTY_RECTANGLES)
+		DirtyRect window;
+	#endif
+
+	#if (ROW_SIGNATURES)
+		uint8_t signature;
+		uint8_t refreshed = 0;
+	#endif
+
+	#if (RLE_SCANOUT)
+		uint8_t run_start;
+		uint8_t run_end;
+	#endif
+
+	#if (RENDER_SCALE > 1)
+		uint8_t *screen_row;		/* The screen row staged from the current frame row. */
+		uint8_t screen_row_bytes;
+	#endif
+
+	#if (SCANOUT_REWINDOWS)
+		uint8_t window_needed = 1;	/* The write area must be set before the next row sent. */
+
+		#if (BANDED_RENDERING)
+			uint8_t row_offset = band_first_row;
+		#else
+			uint8_t row_offset = 0;
+		#endif
+	#endif
+
+	/* With asynchronous scanout, the previous frame (or band) may still be being sent. */
+	waitForFrame();
+
+	#if (DIRTY_RECTANGLES)
+		/* The pixels drawn in the previous frame must be erased as well as those of this frame drawn. */
+		window = frame_dirty_rect;
+
+		#if (INTERLACED)
+			/* Only the rows of the fields sent now are erased, those of the other field were drawn in another frame. */
+			for (uint8_t field = FIELD_EVEN_ROWS; field <= FIELD_ODD_ROWS; field++) {
+				if ( (frame_field == FIELD_ALL_ROWS) || (frame_field == field) ) {
+					mergeDirtyRects(&window, &previousDirtyRects[field]);
+					previousDirtyRects[field] = frame_dirty_rect;
+				}
+			}
+		#else
+			mergeDirtyRects(&window, &previousDirtyRect);
+			previousDirtyRect = frame_dirty_rect;
+		#endif
+
+		if (window.first_row > window.last_row) {
+			/* Nothing has been drawn in either frame, GDRAM is already up to date. */
+			return;
+		}
+
+		/* Whole frame bytes are sent, so the window is widened to an even first column and an odd last column. */
+		first_row = window.first_row;
+		last_row = window.last_row;
+		first_byte = window.first_col / PIXELS_PER_BYTE;
+		last_byte = window.last_col / PIXELS_PER_BYTE;
+	#endif
 
 	/* Drive CS low. */
 	GPIO_DRV_ClearPinOutput(kSSD1331PinCSn);
 
+	#if (ASYNC_SCANOUT)
+		frameInProgress = 1;
+	#endif
+
+	#if (DIRTY_RECTANGLES) && !(SCANOUT_REWINDOWS)
+		setWriteWindow(first_byte * PIXELS_PER_BYTE, first_row, (last_byte * PIXELS_PER_BYTE) + 1, last_row);
+	#endif
+
 	/* Drive DC high. This ensures that the SSD1331 is expecting DATA as opposed to a command. */
 	GPIO_DRV_SetPinOutput(kSSD1331PinDC);
 
-	for (uint8_t row = 0; row < FRAME_NUM_ROWS; row++) {
-		for (uint8_t col = 0; col < FRAME_NUM_COLS; col++) {
-			payload = 0;
+	for (uint8_t row = first_row; row <= last_row; row++) {
+
+		#if (INTERLACED)
+			if (!ROW_IN_FIELD(row_offset + row)) {
+				/* The row belongs to the other field. Send the rows before it, then move the write area past it. */
+				if (rows_staged) {
+					staging = sendStagedRows(staging, staged);
+					staged = staging;
+					rows_staged = 0;
+				}
+
+				window_needed = 1;
+
+				continue;
+			}
+		#endif
+
+		#if (ROW_SIGNATURES)
+			signature = rowSignature(frame[row]);
+
+			if ( (signature == rowSignatures[row_offset + row]) && (row_offset + row != refreshRow) ) {
+				/* GDRAM already holds this row. Send the rows before it, then move the write area past it. */
+				if (rows_staged) {
+					staging = sendStagedRows(staging, staged);
+					staged = staging;
+					rows_staged = 0;
+				}
+
+				window_needed = 1;
+				rowsSkipped++;
+
+				continue;
+			}
+
+			if (row_offset + row == refreshRow) {
+				refreshed = 1;
+			}
+
+			rowSignatures[row_offset + row] = signature;
+			rowsSent++;
+		#endif
+
+		#if (RLE_SCANOUT)
+			run_start = findRun(frame[row], first_byte, last_byte, &run_end);
 
-			pixel_value = get_pixel_value_rowcol(frame, row, col);
+			if (run_start <= last_byte) {
+				/* Send the rows before it, then draw this row part by part. */
+				if (rows_staged) {
+					staging = sendStagedRows(staging, staged);
+					staged = staging;
+					rows_staged = 0;
+				}
 
-			/*
-				Calculate final result to store in the 16 bit payload. This is simply the colour and the ratio of
-				the distance to the maximum distance mapped to the minimum and maximum intensity.
-				Left shift the result as appropriate such that the correct colour is displayed.
+				#if (ASYNC_SCANOUT)
+					/* DC must not change while rows are still being sent. */
+					waitForScanoutTransfer();
+				#endif
 
-				If both colour and intensity are non zero. Zero colour is black (pixel off).
-			*/
-			if ((pixel_value & COLOUR_BITMASK) && (pixel_value & RELATIVE_INTENSITY_BITMASK)) {
-				payload = ( (uint8_t) (MAX_COLOUR_INTENSITY_FLOAT * (((float) (RELATIVE_INTENSITY_FROM_PIXEL_VALUE(pixel_value))) / (MAX_RELATIVE_INTENSITY_FLOAT))) ) << shifts[COLOUR_FROM_PIXEL_VALUE(pixel_value)];
+				writeRowRuns(staging, frame[row], row_offset + row, first_byte, last_byte, run_start, run_end);
+
+				window_needed = 1;
+
+				continue;
+			}
+		#endif
+
+		#if (SCANOUT_REWINDOWS)
+			if (window_needed) {
+				#if (ASYNC_SCANOUT)
+					/* DC must not change while rows are still being sent. */
+					waitForScanoutTransfer();
+				#endif
+
+				setWriteWindow(
+					first_byte * PIXELS_PER_BYTE,
+					row_offset + row,
+					(last_byte * PIXELS_PER_BYTE) + 1,
+					row_offset + last_row
+				);
+
+				GPIO_DRV_SetPinOutput(kSSD1331PinDC);
+
+				window_needed = 0;
+			}
+		#endif
+
+		#if (RENDER_SCALE > 1)
+			screen_row = staged;
+		#endif
+
+		staged = stageRow(staged, frame[row], first_byte, last_byte);
+
+		#if (RENDER_SCALE > 1)
+			screen_row_bytes = staged - screen_row;
+		#endif
+
+		/* The frame row is sent as RENDER_SCALE screen rows. */
+		for (uint8_t repeat = 0; repeat < RENDER_SCALE; repeat++) {
+			#if (RENDER_SCALE > 1)
+				if (repeat) {
+					staged = repeatStagedRow(staged, screen_row, screen_row_bytes);
+				}
+			#endif
+
+			rows_staged++;
+
+			if ( (rows_staged == SCANOUT_ROWS_PER_TRANSFER) || ((row == last_row) && (repeat == RENDER_SCALE - 1)) ) {
+				staging = sendStagedRows(staging, staged);
+				staged = staging;
+				rows_staged = 0;
 			}
+		}
+
+		/* Column and row pointers in SSD1331 internally update as the data is received. */
+	}
+
+	/* Upon the final data read, the SSD1331 resets the internal row and column pointers. */
+
+	#if (ROW_SIGNATURES)
+		#if (DIRTY_RECTANGLES)
+			/* Rows outside of the window are as they were last sent, so need no refresh. */
+			if ( (refreshRow < first_row) || (refreshRow > last_row) ) {
+				refreshed = 1;
+			}
+		#endif
+
+		/* With banding or interlacing, the refresh row may not be in this band or field, and waits for it. */
+		if (refreshed) {
+			refreshRow = (refreshRow + 1) % FRAME_NUM_ROWS;
+		}
+	#endif
+
+	#if !(ASYNC_SCANOUT)
+		/* Drive CS high to complete frame writing interaction. With asynchronous scanout, waitForFrame() does this. */
+		GPIO_DRV_SetPinOutput(kSSD1331PinCSn);
+	#endif
+}
+
+void writeScanline(const uint8_t scanline[2 * FRAME_NUM_COLS])
+{
+	waitForFrame();
+
+	/* Drive CS low. */
+	GPIO_DRV_ClearPinOutput(kSSD1331PinCSn);
+
+	/* Drive DC high. This ensures that the SSD1331 is expecting DATA as opposed to a command. */
+	GPIO_DRV_SetPinOutput(kSSD1331PinDC);
+
+	/*
+		The whole row is sent in one transfer. As in writeFrame(), the GDRAM pointers move on to the next
+		row by themselves and wrap back to the top left of the write area after the last row of the frame.
+	*/
+	writeBytes(scanline, 2 * FRAME_NUM_COLS);
+
+	/* Drive CS high. */
+	GPIO_DRV_SetPinOutput(kSSD1331PinCSn);
+}
+
+/*
+	Initialization sequence, adapted from https://github.com/adafruit/Adafruit-SSD1331-OLED-Driver-Library-for-Arduino
+	Stored in FLASH/ROM and sent as one command list.
+*/
+static const uint8_t initCommands[] =
+{
+	kSSD1331CommandDISPLAYOFF,
+	kSSD1331CommandSETREMAP,		0x72,
+	kSSD1331CommandSTARTLINE,		0x0,
+	kSSD1331CommandDISPLAYOFFSET,		0x0,
+	kSSD1331CommandNORMALDISPLAY,
+	kSSD1331CommandSETMULTIPLEX,		0x3F,
+	kSSD1331CommandSETMASTER,		0x8E,
+	kSSD1331CommandPOWERMODE,		0x0B,
+	kSSD1331CommandPRECHARGE,		0x31,
+	kSSD1331CommandCLOCKDIV,		0xF0 + REFRESH_RATE_DIVISOR,
+	kSSD1331CommandPRECHARGEA,		0x64,
+	kSSD1331CommandPRECHARGEB,		0x78,
+	kSSD1331CommandPRECHARGEA,		0x64,
+	kSSD1331CommandPRECHARGELEVEL,		0x3A,
+	kSSD1331CommandVCOMH,			0x3E,
+	kSSD1331CommandMASTERCURRENT,		0x06,
+	kSSD1331CommandCONTRASTA,		0xFF,
+	kSSD1331CommandCONTRASTB,		0xC8,
+	kSSD1331CommandCONTRASTC,		0xFF,
+	kSSD1331CommandDISPLAYON,
+
+	/* End of standard initialisation sequence. Clear screen. */
+	kSSD1331CommandCLEAR,			0x00, 0x00, 0x5F, 0x3F,
+};
+
+#if (OUTER_FRAME)
+	/* Draw an unfilled white rectangle to demarcate the frame bounds on the display. */
+	static const uint8_t outerFrameCommands[] =
+	{
+		kSSD1331CommandDRAWRECT,
+		(SCREEN_MAX_COLS / 2) - (FRAME_SCREEN_COLS / 2) - 1,	/* Start column. */
+		(SCREEN_MAX_ROWS / 2) - (FRAME_SCREEN_ROWS / 2) - 1,	/* Start row. */
+		(SCREEN_MAX_COLS / 2) + (FRAME_SCREEN_COLS / 2),		/* End column. */
+		(SCREEN_MAX_ROWS / 2) + (FRAME_SCREEN_ROWS / 2),		/* End row. */
+		0xFF, 0xFF, 0xFF,	/* Set outline colour (white). */
+		0, 0, 0			/* Set rectangle fill colour (not used). */
+	};
+#endif
+
+/*
+	Next, we set the write area of the screen. This assumes that the constants defined below are even.
+*/
+static const uint8_t windowCommands[] =
+{
+	#if (HW_PRIMITIVES) || (RLE_SCANOUT) || (DIRECT_HW_SPANS) || (DISPLAY_BUILT(DISPLAY_SSD1331))
+		/*
+			DRAWRECT fills the rectangles drawn by hwFillRect() and ssd1331HwFill(), the runs of run-length scanout
+			and direct spans.
+		*/
+		kSSD1331CommandFILL,	0x01,
+	#endif
+
+	kSSD1331CommandSETCOLUMN,
+	(SCREEN_MAX_COLS / 2) - (FRAME_SCREEN_COLS / 2),		/* Starting column. */
+	(SCREEN_MAX_COLS / 2) + (FRAME_SCREEN_COLS / 2) - 1,	/* End column. */
+
+	kSSD1331CommandSETROW,
+	(SCREEN_MAX_ROWS / 2) - (FRAME_SCREEN_ROWS / 2),		/* Start row. */
+	(SCREEN_MAX_ROWS / 2) + (FRAME_SCREEN_ROWS / 2) - 1	/* End row. */
+};
 
-			/* Split 16 bit representation into two bytes to store in payload_bytes. */
-			payload_bytes[0] = (0xFF00 & payload) >> 8; 	/* MSB. */
-			payload_bytes[1] = (0xFF & payload);			/* LSB. */
+#if (REGISTER_LEVEL_SPI)
+	void printSpiBenchmark(void)
+	{
+		/*
+			The same rows of black pixels are sent through the KSDK driver and through pushBytes(), one row
+			per call as in scanout. The write area is then set again, such that the GDRAM pointers are back at
+			its top left.
+		*/
+		#define SPI_BENCHMARK_ROWS 1000
 
+		uint8_t row[2 * FRAME_NUM_COLS];
+		uint32_t num_bytes = (uint32_t) SPI_BENCHMARK_ROWS * sizeof(row);
+		uint32_t core_kilohertz = CLOCK_SYS_GetCoreClockFreq() / 1000;
+		uint32_t start_milliseconds;
+		uint32_t ksdk_milliseconds;
+		uint32_t register_milliseconds;
+
+		/* MEMSET not used as to avoid introduction of string.h. */
+		for (uint8_t i = 0; i < sizeof(row); i++) {
+			row[i] = 0;
+		}
+
+		waitForFrame();
+
+		/* Drive CS low. */
+		GPIO_DRV_ClearPinOutput(kSSD1331PinCSn);
+
+		/* Drive DC high (data). */
+		GPIO_DRV_SetPinOutput(kSSD1331PinDC);
+
+		start_milliseconds = OSA_TimeGetMsec();
+		for (uint16_t i = 0; i < SPI_BENCHMARK_ROWS; i++) {
 			SPI_DRV_MasterTransferBlocking(
 				0,			/* Master instance. */
 				NULL		/* spi_master_user_config_t */,
-				(const uint8_t * restrict) &payload_bytes[0],
+				(const uint8_t * restrict) row,
 				NULL,
-				2			/* Transfer size in bytes */,
+				sizeof(row)	/* Transfer size in bytes */,
 				1000		/* Timeout in microseconds (unlike I2C which is ms) */);
+		}
+		ksdk_milliseconds = OSA_TimeGetMsec() - start_milliseconds;
 
-			/* Column pointer in SSD1331 internally updates here. */
+		start_milliseconds = OSA_TimeGetMsec();
+		for (uint16_t i = 0; i < SPI_BENCHMARK_ROWS; i++) {
+			pushBytes(row, sizeof(row));
 		}
-		/* Row column pointer in SSD1331 internally updates here. */
+		register_milliseconds = OSA_TimeGetMsec() - start_milliseconds;
+
+		/* Drive CS high. */
+		GPIO_DRV_SetPinOutput(kSSD1331PinCSn);
+
+		writeCommandList(windowCommands, sizeof(windowCommands));
+
+		/* Guard against division by zero. Division can be truncated safely. */
+		ksdk_milliseconds += (ksdk_milliseconds == 0);
+		register_milliseconds += (register_milliseconds == 0);
+
+		warpPrint("KSDK SPI: %d bytes/s, %d cycles/byte.\n",
+			num_bytes * 1000 / ksdk_milliseconds, ksdk_milliseconds * core_kilohertz / num_bytes);
+		warpPrint("Register level SPI: %d bytes/s, %d cycles/byte.\n",
+			num_bytes * 1000 / register_milliseconds, register_milliseconds * core_kilohertz / num_bytes);
 	}
+#endif
 
-	/* Upon the final data read, the SSD1331 resets the internal row and column pointers. */
+#if (DIRECT_RENDERING)
+	void printDirectBreakEven(void)
+	{
+		/*
+			Each is repeated DIRECT_BREAK_EVEN_REPEATS times: a black span of one pixel, a black span of a whole row,
+			and the staging and sending of a whole row of the frame as by writeFrame(), one row per transfer. The first
+			two give the time per span and per pixel, the last that of a frame buffer scanout.
+		*/
+		#define DIRECT_BREAK_EVEN_REPEATS 1000
 
-	/* Drive CS high to complete frame writing interaction. */
-	GPIO_DRV_SetPinOutput(kSSD1331PinCSn);
-}
+		uint8_t row[FRAME_TRUE_COLS];
+		uint8_t *staged;
+		uint32_t start_milliseconds;
+		uint32_t short_milliseconds;
+		uint32_t long_milliseconds;
+		uint32_t row_milliseconds;
+
+		#if (ASYNC_SCANOUT)
+			uint8_t *staging = scanoutBuffers[0];
+		#else
+			uint8_t *staging = scanoutBuffer;
+		#endif
+
+		/* MEMSET not used as to avoid introduction of string.h. */
+		for (uint8_t col = 0; col < FRAME_TRUE_COLS; col++) {
+			row[col] = 0;
+		}
+
+		waitForFrame();
+
+		start_milliseconds = OSA_TimeGetMsec();
+		for (uint16_t i = 0; i < DIRECT_BREAK_EVEN_REPEATS; i++) {
+			directDrawSpan(FRAME_NUM_ROWS - 1, 0, 0, 0);
+		}
+		short_milliseconds = OSA_TimeGetMsec() - start_milliseconds;
+
+		start_milliseconds = OSA_TimeGetMsec();
+		for (uint16_t i = 0; i < DIRECT_BREAK_EVEN_REPEATS; i++) {
+			directDrawSpan(FRAME_NUM_ROWS - 1, 0, FRAME_NUM_COLS - 1, 0);
+		}
+		long_milliseconds = OSA_TimeGetMsec() - start_milliseconds;
+
+		/* Drive CS low. */
+		GPIO_DRV_ClearPinOutput(kSSD1331PinCSn);
+
+		setWriteWindow(0, 0, FRAME_NUM_COLS - 1, 0);
+
+		/* Drive DC high (data). */
+		GPIO_DRV_SetPinOutput(kSSD1331PinDC);
+
+		start_milliseconds = OSA_TimeGetMsec();
+		for (uint16_t i = 0; i < DIRECT_BREAK_EVEN_REPEATS; i++) {
+			staged = stageRow(staging, row, 0, FRAME_TRUE_COLS - 1);
+
+			for (uint8_t repeat = 0; repeat < RENDER_SCALE; repeat++) {
+				writeBytes(staging, staged - staging);
+			}
+		}
+		row_milliseconds = OSA_TimeGetMsec() - start_milliseconds;
+
+		/* Drive CS high. */
+		GPIO_DRV_SetPinOutput(kSSD1331PinCSn);
+
+		/* Only black was drawn, so only the write area has to be set again. */
+		writeCommandList(windowCommands, sizeof(windowCommands));
+
+		/* Division can be truncated safely. */
+		pixelNanoseconds = (long_milliseconds > short_milliseconds) ?
+			(long_milliseconds - short_milliseconds) * (1000000 / DIRECT_BREAK_EVEN_REPEATS) / (FRAME_NUM_COLS - 1) : 0;
+		spanNanoseconds = short_milliseconds * (1000000 / DIRECT_BREAK_EVEN_REPEATS);
+		spanNanoseconds -= (spanNanoseconds > pixelNanoseconds) ? pixelNanoseconds : spanNanoseconds;
+		scanoutMicroseconds = row_milliseconds * (1000 / DIRECT_BREAK_EVEN_REPEATS) * FRAME_NUM_ROWS;
+
+		warpPrint("Direct span: %dns + %dns per pixel. Frame buffer scanout: %dus.\n",
+			spanNanoseconds, pixelNanoseconds, scanoutMicroseconds);
+
+		directSpans = 0;
+		directPixels = 0;
+	}
+
+	void printDirectRenderingCounts(uint32_t num_frames)
+	{
+		/* Division can be truncated safely. */
+		uint32_t triangles = directTriangles / num_frames;
+		uint32_t spans = directSpans / num_frames;
+		uint32_t pixels = directPixels / num_frames;
+
+		/* The frame window is cleared once per frame whatever is drawn. */
+		uint32_t clear_microseconds = 1000 * kSSD1331DelaysHWFILL;
+		uint32_t span_microseconds = ( (spans * spanNanoseconds) + (pixels * pixelNanoseconds) ) / 1000;
+
+		warpPrint("Per frame: %d triangles, %d spans, %d pixels drawn directly.\n", triangles, spans, pixels);
+		warpPrint("Estimated SPI time per frame, direct: %dus, frame buffer: %dus.\n",
+			clear_microseconds + span_microseconds, scanoutMicroseconds);
+
+		if ( (span_microseconds > 0) && (scanoutMicroseconds > clear_microseconds) ) {
+			/* The span time grows in proportion to the triangles drawn, if they are of the same size. */
+			warpPrint("Break-even at about %d triangles, %d pixels per frame.\n",
+				triangles * (scanoutMicroseconds - clear_microseconds) / span_microseconds,
+				pixels * (scanoutMicroseconds - clear_microseconds) / span_microseconds);
+		}
+
+		directTriangles = 0;
+		directSpans = 0;
+		directPixels = 0;
+	}
+#endif
+
+#if (DISPLAY_BUILT(DISPLAY_SSD1331))
+	/* Set once ssd1331SetWindow() has moved the write area off the frame window, which writeFrame() expects. */
+	static uint8_t windowMoved = 0;
+
+	void ssd1331SetWindow(uint8_t first_col, uint8_t first_row, uint8_t last_col, uint8_t last_row)
+	{
+		waitForFrame();
+
+		/* Drive CS low. */
+		GPIO_DRV_ClearPinOutput(kSSD1331PinCSn);
+
+		setWriteWindow(first_col, first_row, last_col, last_row);
+
+		/* Drive CS high. */
+		GPIO_DRV_SetPinOutput(kSSD1331PinCSn);
+
+		windowMoved = 1;
+	}
+
+	void ssd1331PushPixels(const uint8_t *pixels, uint8_t num_pixels)
+	{
+		#if (ASYNC_SCANOUT)
+			uint8_t *staging = scanoutBuffers[0];
+		#else
+			uint8_t *staging = scanoutBuffer;
+		#endif
+
+		if (num_pixels == 0) {
+			return;
+		}
+
+		waitForFrame();
+
+		/* Drive CS low. */
+		GPIO_DRV_ClearPinOutput(kSSD1331PinCSn);
+
+		/* Drive DC high (data). */
+		GPIO_DRV_SetPinOutput(kSSD1331PinDC);
+
+		/* Whole bytes are staged. Of an odd number of pixels, the unused upper nibble of the last is not sent. */
+		stageRow(staging, pixels, 0, (num_pixels - 1) / PIXELS_PER_BYTE);
+
+		/* The row of the window covers RENDER_SCALE rows of the write area. */
+		for (uint8_t repeat = 0; repeat < RENDER_SCALE; repeat++) {
+			writeBytes(staging, 2 * RENDER_SCALE * num_pixels);
+		}
+
+		/* Drive CS high. */
+		GPIO_DRV_SetPinOutput(kSSD1331PinCSn);
+	}
+
+	void ssd1331HwFill(uint8_t first_col, uint8_t first_row, uint8_t last_col, uint8_t last_row, uint8_t pixel_value)
+	{
+		uint8_t commands[11];
+
+		commands[1] = SCREEN_COL(first_col);
+		commands[2] = SCREEN_ROW(first_row);
+		commands[3] = SCREEN_COL_END(last_col);
+		commands[4] = SCREEN_ROW_END(last_row);
+
+		if (pixel_value == 0) {
+			commands[0] = kSSD1331CommandCLEAR;
+			writeCommandList(commands, 5);
+
+		} else {
+			/* Outline and fill the same colour. */
+			commands[0] = kSSD1331CommandDRAWRECT;
+			setDrawColour(&commands[5], pixel_value);
+			setDrawColour(&commands[8], pixel_value);
+			writeCommandList(commands, sizeof(commands));
+		}
+
+		OSA_TimeDelay(kSSD1331DelaysHWFILL);
+	}
+
+	void ssd1331Flush(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS])
+	{
+		if (frame == NULL) {
+			waitForFrame();
+			return;
+		}
+
+		if (windowMoved) {
+			writeCommandList(windowCommands, sizeof(windowCommands));
+			windowMoved = 0;
+		}
+
+		writeFrame(frame);
+	}
+#endif
 
 void devSSD1331init(void)
 {
@@ -164,96 +1455,35 @@ void devSSD1331init(void)
 
 	/*
 	 *	RST high->low->high.
+	 *
+	 *	The SSD1331 needs RST low for at least 3us (tRES in the datasheet). 1ms is the shortest OSA_TimeDelay().
 	 */
 	GPIO_DRV_SetPinOutput(kSSD1331PinRST);
-	OSA_TimeDelay(100);
+	OSA_TimeDelay(1);
 	GPIO_DRV_ClearPinOutput(kSSD1331PinRST);
-	OSA_TimeDelay(100);
+	OSA_TimeDelay(1);
 	GPIO_DRV_SetPinOutput(kSSD1331PinRST);
-	OSA_TimeDelay(100);
+	OSA_TimeDelay(1);
 
-	/*
-		Initialization sequence, adapted from https://github.com/adafruit/Adafruit-SSD1331-OLED-Driver-Library-for-Arduino
-	 */
-	writeCommand(kSSD1331CommandDISPLAYOFF);
-	writeCommand(kSSD1331CommandSETREMAP);
-	writeCommand(0x72);
-	writeCommand(kSSD1331CommandSTARTLINE);
-	writeCommand(0x0);
-	writeCommand(kSSD1331CommandDISPLAYOFFSET);
-	writeCommand(0x0);
-	writeCommand(kSSD1331CommandNORMALDISPLAY);
-	writeCommand(kSSD1331CommandSETMULTIPLEX);
-	writeCommand(0x3F);
-	writeCommand(kSSD1331CommandSETMASTER);
-	writeCommand(0x8E);
-	writeCommand(kSSD1331CommandPOWERMODE);
-	writeCommand(0x0B);
-	writeCommand(kSSD1331CommandPRECHARGE);
-	writeCommand(0x31);
-	writeCommand(kSSD1331CommandCLOCKDIV);
-	writeCommand(0xF0 + REFRESH_RATE_DIVISOR);
-	writeCommand(kSSD1331CommandPRECHARGEA);
-	writeCommand(0x64);
-	writeCommand(kSSD1331CommandPRECHARGEB);
-	writeCommand(0x78);
-	writeCommand(kSSD1331CommandPRECHARGEA);
-	writeCommand(0x64);
-	writeCommand(kSSD1331CommandPRECHARGELEVEL);
-	writeCommand(0x3A);
-	writeCommand(kSSD1331CommandVCOMH);
-	writeCommand(0x3E);
-	writeCommand(kSSD1331CommandMASTERCURRENT);
-	writeCommand(0x06);
-	writeCommand(kSSD1331CommandCONTRASTA);
-	writeCommand(0xFF);
-	writeCommand(kSSD1331CommandCONTRASTB);
-	writeCommand(0xC8);
-	writeCommand(kSSD1331CommandCONTRASTC);
-	writeCommand(0xFF);
-	writeCommand(kSSD1331CommandDISPLAYON);
-
-	/* End of standard initialisation sequence. */
-
-	/* Clear screen. */
-
-	writeCommand(kSSD1331CommandCLEAR);
-	writeCommand(0x00);
-	writeCommand(0x00);
-	writeCommand(0x5F);
-	writeCommand(0x3F);
+	/* Initialisation sequence and clear screen, in one transfer. */
+	writeCommandList(initCommands, sizeof(initCommands));
+	OSA_TimeDelay(kSSD1331DelaysHWFILL);
 
 	#if (OUTER_FRAME)
-
-		/* Draw an unfilled white rectangle to demarcate the frame bounds on the display. */
-
-		writeCommand(kSSD1331CommandDRAWRECT);
-		writeCommand((SCREEN_MAX_COLS / 2) - (FRAME_NUM_COLS / 2) - 1); /* Start column. */
-		writeCommand((SCREEN_MAX_ROWS / 2) - (FRAME_NUM_ROWS / 2) - 1); /* Start row. */
-		writeCommand((SCREEN_MAX_COLS / 2) + (FRAME_NUM_COLS / 2)); /* End column. */
-		writeCommand((SCREEN_MAX_ROWS / 2) + (FRAME_NUM_ROWS / 2)); /* End row. */
-
-		/* Set outline colour (white). */
-		writeCommand(0xFF);
-		writeCommand(0xFF);
-		writeCommand(0xFF);
-
-		/* Set rectangle fill colour (not used). */
-		writeCommand(0);
-		writeCommand(0);
-		writeCommand(0);
-
+		writeCommandList(outerFrameCommands, sizeof(outerFrameCommands));
+		OSA_TimeDelay(kSSD1331DelaysHWFILL);
 	#endif
 
-	/*
-		Next, we set the write area of the screen. This assumes that the constants defined below are even.
-	*/
+	writeCommandList(windowCommands, sizeof(windowCommands));
+}
 
-	writeCommand(kSSD1331CommandSETCOLUMN);
-	writeCommand((SCREEN_MAX_COLS / 2) - (FRAME_NUM_COLS / 2)); /* Starting column. */
-	writeCommand((SCREEN_MAX_COLS / 2) + (FRAME_NUM_COLS / 2) - 1); /* End column. */
-	
-	writeCommand(kSSD1331CommandSETROW);
-	writeCommand((SCREEN_MAX_ROWS / 2) - (FRAME_NUM_ROWS / 2)); /* Start row. */
-	writeCommand((SCREEN_MAX_ROWS / 2) + (FRAME_NUM_ROWS / 2) - 1); /* End row. */
-}
\ No newline at end of file
+#if (DISPLAY_BUILT(DISPLAY_SSD1331)) && (DISPLAY_VTABLE)
+	const DisplayBackend ssd1331Display =
+	{
+		devSSD1331init,
+		ssd1331SetWindow,
+		ssd1331PushPixels,
+		ssd1331HwFill,
+		ssd1331Flush
+	};
+#endif
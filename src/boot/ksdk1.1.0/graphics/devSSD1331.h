@@ -68,4 +68,99 @@ typedef enum
 } SSD1331Commands;
 
 void devSSD1331init(void);
-void writeFrame(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS]);
\ No newline at end of file
+
+/*
+	Sends a list of command bytes, with their arguments, in one transfer under a single /CS assertion.
+	Commands which draw (DRAWLINE, DRAWRECT, CLEAR) must be followed by kSSD1331DelaysHWLINE or kSSD1331DelaysHWFILL
+	before the next command or data. Returns the status of the SPI transfer.
+*/
+int writeCommandList(const uint8_t *commands, uint8_t num_bytes);
+void writeFrame(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS]);
+
+/* With asynchronous scanout, waits until the frame started by writeFrame() has been sent. Returns immediately otherwise. */
+void waitForFrame(void);
+
+/* Converts a 4 bit pixel value (colour and relative intensity) into the 16 bit colour format of GDRAM. */
+uint16_t pixelValueToColour(uint8_t pixel_value);
+
+/* Writes one row of the frame, already in GDRAM colour format, MSB first. Used by the scanline renderer. */
+void writeScanline(const uint8_t scanline[2 * FRAME_NUM_COLS]);
+
+#if (DISPLAY_BUILT(DISPLAY_SSD1331))
+	/*
+		The display backend functions of the SSD1331, see DisplayBackend in graphics.h. devSSD1331init() is its init.
+		ssd1331Flush() sends a frame with writeFrame(), and so with the scanout options of graphics.h, and with NULL
+		calls waitForFrame(). A window set by ssd1331SetWindow() is replaced by the frame window before the frame is sent.
+	*/
+	void ssd1331SetWindow(uint8_t first_col, uint8_t first_row, uint8_t last_col, uint8_t last_row);
+	void ssd1331PushPixels(const uint8_t *pixels, uint8_t num_pixels);
+	void ssd1331HwFill(uint8_t first_col, uint8_t first_row, uint8_t last_col, uint8_t last_row, uint8_t pixel_value);
+	void ssd1331Flush(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS]);
+
+	#if (DISPLAY_VTABLE)
+		extern const DisplayBackend ssd1331Display;
+	#endif
+#endif
+
+#if (HW_PRIMITIVES)
+	/*
+		Drawn by the SSD1331 itself rather than through the frame array, in frame coordinates with (0, 0) at the
+		bottom left. pixel_value is a 4 bit pixel value (colour and relative intensity) as held in the frame.
+	*/
+	void hwDrawLine(const uint8_t point_0[2], const uint8_t point_1[2], uint8_t pixel_value);
+	void hwFillRect(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t pixel_value);
+#endif
+
+#if (HW_PRIMITIVES) || (DIRECT_RENDERING)
+	/* Clears the frame window of the display to black. */
+	void hwClearFrame(void);
+#endif
+
+#if (DIRECT_RENDERING)
+	/* Triangles drawn by drawTriangle(), counted for printDirectRenderingCounts(). */
+	extern uint32_t directTriangles;
+
+	/*
+		Draws the pixels x0 to x1 at y, in frame coordinates, straight to the display. Spans outside of the frame
+		are clipped to it. pixel_value is a 4 bit pixel value (colour and relative intensity) as held in the frame.
+	*/
+	void directDrawSpan(uint8_t y, uint8_t x0, uint8_t x1, uint8_t pixel_value);
+
+	/*
+		Times span writes of one and of FRAME_NUM_COLS pixels, and the scanout of frame rows, and prints the time
+		per span, per pixel and per frame buffer scanout. Only black is drawn, over the first row of the frame window.
+	*/
+	void printDirectBreakEven(void);
+
+	/*
+		Prints the average triangles, spans and pixels drawn per frame over num_frames frames, the estimated SPI time
+		per frame of both paths and where they cross over, then resets the counts.
+	*/
+	void printDirectRenderingCounts(uint32_t num_frames);
+#endif
+
+#if (REGISTER_LEVEL_SPI)
+	/*
+		Send bytes to the display by writing the SPI0 data register directly, without the KSDK driver.
+		CS and DC must already be driven. Return once the last byte has been shifted out.
+		pushPixelRun() sends num_pixels pixels of one 16 bit GDRAM colour.
+	*/
+	void pushBytes(const uint8_t *bytes, uint16_t num_bytes);
+	void pushPixelRun(uint16_t colour, uint16_t num_pixels);
+
+	/* Prints the bytes per second and core cycles per byte of the KSDK driver and of pushBytes(). */
+	void printSpiBenchmark(void);
+#endif
+
+#if (RLE_SCANOUT)
+	/*
+		Times run fills against data writes and prints the shortest run, in pixels, worth filling (see RLE_MIN_RUN).
+		Draws over the frame window of the display, which is cleared afterwards.
+	*/
+	void printRleBreakEven(void);
+#endif
+
+#if (ROW_SIGNATURES)
+	/* Prints the average rows sent and skipped per frame by writeFrame() over num_frames frames, then resets the counts. */
+	void printScanoutRowCounts(uint32_t num_frames);
+#endif
\ No newline at end of file
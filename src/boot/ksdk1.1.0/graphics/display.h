@@ -0,0 +1,73 @@
+#ifndef STDINT
+	#include <stdint.h>
+	#define STDINT
+#endif
+
+#ifndef GRAPHICS
+	#include "graphics.h"
+	#define GRAPHICS
+#endif
+
+#if (DISPLAY_BUILT(DISPLAY_SSD1331))
+    #include "devSSD1331.h"
+#endif
+
+#if (DISPLAY_BUILT(DISPLAY_SSD1306))
+    #include "devSSD1306.h"
+#endif
+
+#if (DISPLAY_BUILT(DISPLAY_HOST))
+    #include "display_host.h"
+#endif
+
+/*
+    The display functions through which the renderer draws, those of DisplayBackend in graphics.h.
+
+    Without DISPLAY_VTABLE, each is the function of DISPLAY_BACKEND itself, so calls are direct and bound at compile
+    time. With DISPLAY_VTABLE, each calls through the display pointer.
+*/
+#if (DISPLAY_VTABLE)
+
+    /* The backend drawn on, initially that of DISPLAY_BACKEND. displayInit() must be called after it is changed. */
+    extern const DisplayBackend *display;
+
+    #define displayInit         display->init
+    #define displaySetWindow    display->set_window
+    #define displayPushPixels   display->push_pixels
+    #define displayHwFill       display->hw_fill
+    #define displayFlush        display->flush
+
+#elif (DISPLAY_BACKEND == DISPLAY_SSD1331)
+
+    #define displayInit         devSSD1331init
+    #define displaySetWindow    ssd1331SetWindow
+    #define displayPushPixels   ssd1331PushPixels
+    #define displayHwFill       ssd1331HwFill
+    #define displayFlush        ssd1331Flush
+
+#elif (DISPLAY_BACKEND == DISPLAY_SSD1306)
+
+    #define displayInit         devSSD1306init
+    #define displaySetWindow    ssd1306SetWindow
+    #define displayPushPixels   ssd1306PushPixels
+    #define displayHwFill       ssd1306HwFill
+    #define displayFlush        ssd1306Flush
+
+#elif (DISPLAY_BACKEND == DISPLAY_HOST)
+
+    #define displayInit         hostDisplayInit
+    #define displaySetWindow    hostDisplaySetWindow
+    #define displayPushPixels   hostDisplayPushPixels
+    #define displayHwFill       hostDisplayHwFill
+    #define displayFlush        hostDisplayFlush
+
+#else
+    #error "DISPLAY_BACKEND must be one of DISPLAY_SSD1331, DISPLAY_SSD1306 or DISPLAY_HOST."
+#endif
+
+/* Called by the renderer on writing pixels first_col to last_col of a row of the frame array, see display_host.h. */
+#if (DISPLAY_BACKEND == DISPLAY_HOST)
+    #define COUNT_PIXEL_WRITES(row, first_col, last_col) hostCountPixelWrites(row, first_col, last_col)
+#else
+    #define COUNT_PIXEL_WRITES(row, first_col, last_col)
+#endif
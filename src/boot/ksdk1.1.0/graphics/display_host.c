@@ -0,0 +1,219 @@
+#include <stdint.h>
+
+#include "display_host.h"
+
+#if (DISPLAY_BACKEND == DISPLAY_HOST)
+
+#include <stdio.h>
+
+/* Pixel value of each pixel of the frame, as last drawn. */
+static uint8_t image[FRAME_NUM_ROWS][FRAME_NUM_COLS];
+static uint8_t imageChanged = 0;
+static unsigned long imagesWritten = 0;
+
+/* Window set by hostDisplaySetWindow(), and its row written next by hostDisplayPushPixels(). */
+static uint8_t windowFirstCol = 0;
+static uint8_t windowLastCol = FRAME_NUM_COLS - 1;
+static uint8_t windowRow = 0;
+
+static uint32_t commandBytes = 0;
+static uint32_t dataBytes = 0;
+
+/* Whether each pixel of the frame has been written by the renderer since the last frame was flushed. */
+static uint8_t pixelWritten[FRAME_NUM_ROWS][FRAME_NUM_COLS];
+static uint32_t pixelWrites = 0;
+static uint32_t pixelOverdraws = 0;
+static uint32_t pixelGaps = 0;
+
+/*
+    Counts the pixels of the frame left unwritten between two written pixels of the same row or of the same column.
+    A convex mesh, as the cube is seen, covers a run of whole pixels of each, so any such pixel is a crack between
+    triangles.
+*/
+static void countGaps(void)
+{
+    /* The first and last written pixel of each row and column, or FRAME_NUM_COLS or FRAME_NUM_ROWS and 0 if none. */
+    uint8_t row_first[FRAME_NUM_ROWS];
+    uint8_t row_last[FRAME_NUM_ROWS];
+    uint8_t col_first[FRAME_NUM_COLS];
+    uint8_t col_last[FRAME_NUM_COLS];
+
+    for (uint8_t row = 0; row < FRAME_NUM_ROWS; row++) {
+        row_first[row] = FRAME_NUM_COLS;
+        row_last[row] = 0;
+    }
+
+    for (uint8_t col = 0; col < FRAME_NUM_COLS; col++) {
+        col_first[col] = FRAME_NUM_ROWS;
+        col_last[col] = 0;
+    }
+
+    for (uint8_t row = 0; row < FRAME_NUM_ROWS; row++) {
+        for (uint8_t col = 0; col < FRAME_NUM_COLS; col++) {
+            if (pixelWritten[row][col]) {
+                row_first[row] = (col < row_first[row]) ? col : row_first[row];
+                row_last[row] = col;
+                col_first[col] = (row < col_first[col]) ? row : col_first[col];
+                col_last[col] = row;
+            }
+        }
+    }
+
+    for (uint8_t row = 0; row < FRAME_NUM_ROWS; row++) {
+        for (uint8_t col = 0; col < FRAME_NUM_COLS; col++) {
+            if ( !pixelWritten[row][col] && (((col > row_first[row]) && (col < row_last[row])) ||
+                ((row > col_first[col]) && (row < col_last[col]))) ) {
+                pixelGaps++;
+            }
+        }
+    }
+}
+
+/* Writes the image as a binary PPM, each colour at its relative intensity out of MAX_RELATIVE_INTENSITY. */
+static void writeImage(void)
+{
+    char name[32];
+    FILE *file;
+    uint8_t pixel_value;
+    uint8_t channels[3];
+
+    snprintf(name, sizeof(name), HOST_DISPLAY_IMAGE_NAME, imagesWritten++);
+
+    file = fopen(name, "wb");
+
+    if (file == NULL) {
+        return;
+    }
+
+    fprintf(file, "P6\n%d %d\n255\n", FRAME_SCREEN_COLS, FRAME_SCREEN_ROWS);
+
+    for (uint16_t screen_row = 0; screen_row < FRAME_SCREEN_ROWS; screen_row++) {
+        for (uint16_t screen_col = 0; screen_col < FRAME_SCREEN_COLS; screen_col++) {
+            pixel_value = image[screen_row / RENDER_SCALE][screen_col / RENDER_SCALE];
+
+            /* Colours R, G and B are 1, 2 and 3. */
+            for (uint8_t colour = R; colour <= B; colour++) {
+                channels[colour - R] = (COLOUR_FROM_PIXEL_VALUE(pixel_value) == colour) ?
+                    (255 * RELATIVE_INTENSITY_FROM_PIXEL_VALUE(pixel_value)) / MAX_RELATIVE_INTENSITY : 0;
+            }
+
+            fwrite(channels, 1, sizeof(channels), file);
+        }
+    }
+
+    fclose(file);
+}
+
+void hostDisplayInit(void)
+{
+    hostDisplayHwFill(0, 0, FRAME_NUM_COLS - 1, FRAME_NUM_ROWS - 1, 0);
+
+    /* The display starts cleared, there is no image of it. */
+    imageChanged = 0;
+    commandBytes = 0;
+}
+
+void hostDisplaySetWindow(uint8_t first_col, uint8_t first_row, uint8_t last_col, uint8_t last_row)
+{
+    /* The rows are written in turn from the first by hostDisplayPushPixels(), which does not need the last. */
+    (void) last_row;
+
+    windowFirstCol = first_col;
+    windowLastCol = last_col;
+    windowRow = first_row;
+
+    /* SETCOLUMN and SETROW. */
+    commandBytes += 6;
+}
+
+void hostDisplayPushPixels(const uint8_t *pixels, uint8_t num_pixels)
+{
+    uint8_t col = windowFirstCol;
+
+    for (uint8_t i = 0; (i < num_pixels) && (col <= windowLastCol); i++, col++) {
+        image[windowRow][col] = (pixels[i / PIXELS_PER_BYTE] >> (BITS_PER_PIXEL * (i % PIXELS_PER_BYTE))) & PIXEL_BITMASK;
+    }
+
+    windowRow++;
+    imageChanged = 1;
+
+    dataBytes += 2 * RENDER_SCALE * RENDER_SCALE * num_pixels;
+}
+
+void hostDisplayHwFill(uint8_t first_col, uint8_t first_row, uint8_t last_col, uint8_t last_row, uint8_t pixel_value)
+{
+    for (uint8_t row = first_row; row <= last_row; row++) {
+        for (uint8_t col = first_col; col <= last_col; col++) {
+            image[row][col] = pixel_value;
+        }
+    }
+
+    imageChanged = 1;
+
+    /* CLEAR, or DRAWRECT with its two colours. */
+    commandBytes += (pixel_value == 0) ? 5 : 11;
+}
+
+void hostCountPixelWrites(uint8_t row, uint8_t first_col, uint8_t last_col)
+{
+    for (uint8_t col = first_col; col <= last_col; col++) {
+        pixelOverdraws += pixelWritten[row][col];
+        pixelWritten[row][col] = 1;
+    }
+
+    pixelWrites += last_col + 1 - first_col;
+}
+
+void hostDisplayFlush(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS])
+{
+    if (frame != NULL) {
+        countGaps();
+
+        for (uint8_t row = 0; row < FRAME_NUM_ROWS; row++) {
+            for (uint8_t col = 0; col < FRAME_NUM_COLS; col++) {
+                image[row][col] = get_pixel_value_rowcol(frame, row, col);
+
+                /* The next frame is drawn from scratch. */
+                pixelWritten[row][col] = 0;
+            }
+        }
+
+        imageChanged = 1;
+
+        dataBytes += 2 * FRAME_SCREEN_ROWS * FRAME_SCREEN_COLS;
+    }
+
+    if (imageChanged) {
+        writeImage();
+        imageChanged = 0;
+    }
+}
+
+void printHostDisplayCounts(uint32_t num_frames)
+{
+    printf("Bytes per frame: %lu command, %lu data.\n",
+        (unsigned long) (commandBytes / num_frames), (unsigned long) (dataBytes / num_frames));
+
+    /* Not averaged, such that a single overdrawn or missed pixel shows. */
+    printf("Pixel writes: %lu per frame, %lu overdraws and %lu gaps in all.\n",
+        (unsigned long) (pixelWrites / num_frames), (unsigned long) pixelOverdraws, (unsigned long) pixelGaps);
+
+    commandBytes = 0;
+    dataBytes = 0;
+    pixelWrites = 0;
+    pixelOverdraws = 0;
+    pixelGaps = 0;
+}
+
+#if (DISPLAY_VTABLE)
+    const DisplayBackend hostDisplay =
+    {
+        hostDisplayInit,
+        hostDisplaySetWindow,
+        hostDisplayPushPixels,
+        hostDisplayHwFill,
+        hostDisplayFlush
+    };
+#endif
+
+#endif
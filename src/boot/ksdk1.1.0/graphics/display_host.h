@@ -0,0 +1,57 @@
+#ifndef STDINT
+	#include <stdint.h>
+	#define STDINT
+#endif
+
+#ifndef GRAPHICS
+	#include "graphics.h"
+	#define GRAPHICS
+#endif
+
+#if (DISPLAY_BACKEND == DISPLAY_HOST)
+
+    /*
+        The display backend functions of a host build, see DisplayBackend in graphics.h.
+
+        Frames are held as pixel values and written out by hostDisplayFlush() as PPM images, scaled by RENDER_SCALE,
+        to files named by HOST_DISPLAY_IMAGE_NAME. Nothing is written for a frame drawn with the other functions unless
+        they have been called since the last image.
+
+        The bytes an SSD1331 would be sent are counted instead: 6 command bytes per window, 5 per black fill and 11
+        per other fill, and 2 data bytes per screen pixel pushed. A frame is counted as a whole frame window of data,
+        as writeFrame() sends it without the scanout options of graphics.h.
+    */
+    /* printf() format of the image file names, given the number of the image from 0. */
+    #define HOST_DISPLAY_IMAGE_NAME "frame%05lu.ppm"
+
+    void hostDisplayInit(void);
+    void hostDisplaySetWindow(uint8_t first_col, uint8_t first_row, uint8_t last_col, uint8_t last_row);
+    void hostDisplayPushPixels(const uint8_t *pixels, uint8_t num_pixels);
+    void hostDisplayHwFill(uint8_t first_col, uint8_t first_row, uint8_t last_col, uint8_t last_row, uint8_t pixel_value);
+    void hostDisplayFlush(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS]);
+
+    #if (DISPLAY_VTABLE)
+        extern const DisplayBackend hostDisplay;
+    #endif
+
+    /*
+        Counts the writes of the pixels first_col to last_col of a row of the frame array by the renderer, through
+        COUNT_PIXEL_WRITES() of display.h. An overdraw is a write of a pixel already written since the last frame was
+        flushed, which wastes fill. A gap is a pixel left unwritten between two written pixels of its row or column
+        when the frame is flushed, a crack between the triangles of a convex mesh.
+
+        The half-space rasteriser with SUBPIXEL_BITS of 2 or more draws the cube demo with neither. The defaults do
+        not. The span rasteriser draws the pixels of an edge shared by two triangles for both, and its Bresenham runs
+        can miss one, for 360320 overdraws and 5140 gaps over the 5100 frames. The half-space rasteriser with
+        SUBPIXEL_BITS 0 overdraws 480 pixels: a face seen nearly edge on passes the back-face test in 3D, but, its
+        vertices rounded to pixel centres, projects with its winding reversed and is drawn over its neighbours.
+    */
+    void hostCountPixelWrites(uint8_t row, uint8_t first_col, uint8_t last_col);
+
+    /*
+        Prints the average command and data bytes and pixel writes counted per frame over num_frames frames, and the
+        overdraws and gaps in all, then resets the counts.
+    */
+    void printHostDisplayCounts(uint32_t num_frames);
+
+#endif
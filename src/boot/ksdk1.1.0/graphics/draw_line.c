@@ -1,6 +1,7 @@
 #include <stdint.h>
 
 #include "draw_line.h"
+#include "display.h"
 
 static void drawLineOctant1(
     uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS],
@@ -149,7 +150,97 @@ void drawHorizontalLine(
     uint8_t relative_intensity
 )
 {
-    for (uint8_t x = x0; x <= x1; x++) {
-        drawPixel(frame, x, y, colour, relative_intensity);
-    }
+    #if (DIRECT_RENDERING)
+
+        /* The frame array is not used. */
+        directDrawSpan(y, x0, x1, colour + (relative_intensity << PIXELS_PER_BYTE));
+
+    #elif (SPAN_FILL)
+
+        uint8_t *row;               /* Row of the frame containing the span. */
+        uint8_t *byte;              /* Byte currently being written. */
+        uint8_t num_bytes;          /* Number of whole bytes (pixel pairs) in the span interior. */
+        uint8_t pixel_value;        /* 4 bit pixel value, colour and relative intensity. */
+        uint8_t pattern;            /* pixel_value replicated into both pixels of a byte. */
+        uint32_t pattern_word;      /* pattern replicated into all four bytes of a word. */
+
+        if (x0 > x1) {
+            return;
+        }
+
+        pixel_value = colour + (relative_intensity << PIXELS_PER_BYTE);
+        pattern = pixel_value + (pixel_value << BITS_PER_PIXEL);
+
+        #if (BANDED_RENDERING)
+            /* Span does not lie in the current band. */
+            if (FRAME_ROW(y) >= BAND_NUM_ROWS) {
+                return;
+            }
+        #endif
+
+        #if (INTERLACED)
+            /* Span does not lie in the current field. */
+            if (!ROW_IN_FIELD(FRAME_NUM_ROWS - y - 1)) {
+                return;
+            }
+        #endif
+
+        row = frame[FRAME_ROW(y)];
+
+        COUNT_PIXEL_WRITES(FRAME_ROW(y), x0, x1);
+
+        /*
+            Odd leading pixel. It shares its byte with the pixel to its left, which lies
+            outside the span, so only the upper nibble is replaced.
+        */
+        if (x0 % PIXELS_PER_BYTE) {
+            row[x0 / PIXELS_PER_BYTE] = (row[x0 / PIXELS_PER_BYTE] & PIXEL_BITMASK) + (pixel_value << BITS_PER_PIXEL);
+            x0++;
+        }
+
+        /*
+            x0 is now even (or one past x1). Every byte between x0 and the last odd x <= x1 is
+            entirely covered by the span and can be overwritten without reading it first.
+        */
+        byte = &row[x0 / PIXELS_PER_BYTE];
+        num_bytes = (x1 + 1 - x0) / PIXELS_PER_BYTE;
+
+        /* Bring the write pointer up to a word boundary, then write four bytes (eight pixels) at a time. */
+        while ( num_bytes && ((uintptr_t) byte % sizeof(uint32_t)) ) {
+            *byte++ = pattern;
+            num_bytes--;
+        }
+
+        pattern_word = pattern * 0x01010101UL;
+
+        /*
+            The word is stored through memcpy() rather than a uint32_t pointer, which would alias
+            the uint8_t frame. The M0+ has no unaligned stores, so the alignment reached above is
+            passed on and the fixed size memcpy() compiles to one str. The builtin keeps string.h out.
+        */
+        while (num_bytes >= sizeof(uint32_t)) {
+            __builtin_memcpy(__builtin_assume_aligned(byte, sizeof(uint32_t)), &pattern_word, sizeof(uint32_t));
+            byte += sizeof(uint32_t);
+            num_bytes -= sizeof(uint32_t);
+        }
+
+        while (num_bytes--) {
+            *byte++ = pattern;
+        }
+
+        /*
+            Even trailing pixel. It shares its byte with the pixel to its right, which lies
+            outside the span, so only the lower nibble is replaced.
+        */
+        if ( (x0 <= x1) && !(x1 % PIXELS_PER_BYTE) ) {
+            *byte = (*byte & (PIXEL_BITMASK << BITS_PER_PIXEL)) + pixel_value;
+        }
+
+    #else
+
+        for (uint8_t x = x0; x <= x1; x++) {
+            drawPixel(frame, x, y, colour, relative_intensity);
+        }
+
+    #endif
 }
\ No newline at end of file
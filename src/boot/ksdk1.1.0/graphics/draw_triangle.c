@@ -2,6 +2,15 @@
 
 #include "draw_line.h"
 #include "draw_triangle.h"
+#include "clip.h"
+#include "display.h"
+
+#if (RASTERISER_BENCHMARK)
+    #include "warp.h"
+#endif
+
+/* The span filler, which takes whole pixel vertices. */
+#if (!(WIREFRAME) && !(HALF_SPACE_RASTERISER)) || (RASTERISER_BENCHMARK)
 
 static void swap2DVertices(uint8_t v0[2], uint8_t v1[2])
 {
@@ -282,92 +291,493 @@ static void drawFlatBottomTriangle(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COL
     }
 }
 
-void drawTriangle(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], Triangle2D tri)
+/*
+    Fills a triangle as a flat top and a flat bottom triangle, split at the height of its middle vertex.
+*/
+static void drawTriangleSpans(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], Triangle2D tri)
 {
-    #if (WIREFRAME)
+    /* Sort triangle vertices in ascending order. Triangle will be drawn from the bottom up. */
+    sortTriangle2DVertices(&tri);
+
+    /* Simple case of top flat triangle only. */
+    if (tri.vs[0][Y] == tri.vs[1][Y]) {
+        drawFlatTopTriangle(frame, tri);
+        return;
+    }
+
+    /* Simple case of bottom flat triangle only. */
+    if (tri.vs[1][Y] == tri.vs[2][Y]) {
+        drawFlatBottomTriangle(frame, tri);
+        return;
+    }
+
+    /*
+        General Case. We split the triangle into two - a flat top and a flat bottom. 
+        We then draw both.
+
+        To do this, we first find the common fourth point. It lies along the hypotenuse
+        and shares an x value with tri.vs[1], if the vertices are sorted correctly as above.
+        To find the y coordinate of this point, we apply Thales' theorem to interpolate
+        the hypotenuse ar this x value. We will call this point Q.
+    */
+    uint8_t Q[2];
+
+    /*
+        x_Q = (x_2 - x_0)\frac{y_1 - y_0}{y_2 - y_0} + x_0
+        The float divide is rounded as opposed to truncated as of course, with an
+        extremal point like Q, the importance of rounding up is that much higher.
+
+        Value found is incremented by 0.5 such that the casting process preforms a rounding operation.
+    */
+    Q[X] = (uint8_t) ( tri.vs[0][X] + (tri.vs[2][X] - tri.vs[0][X]) * ( ( (float) (tri.vs[1][Y] - tri.vs[0][Y]) / (float) (tri.vs[2][Y] - tri.vs[0][Y]) ) ) + 0.5);
+    Q[Y] = tri.vs[1][Y];
+
+    /*
+        We first draw the bottom half, being the top flat triangle.
 
-        drawLine(frame, tri.vs[0], tri.vs[1], tri.colour, tri.relative_intensity);
-        drawLine(frame, tri.vs[1], tri.vs[2], tri.colour, tri.relative_intensity);
-        drawLine(frame, tri.vs[2], tri.vs[0], tri.colour, tri.relative_intensity);
+        In doing this, we also INCLUDE the horizontal line at Q[Y]. We don't
+        include this during the drawing of the top half as it doesn't need to be drawn
+        twice.
 
+        Following the sorting of the triangle vertices, we must temporarily
+        substitute Q for the top-most vertex. We then draw the resulting top-flat triangle.
+    */
+
+    /* Substitute in Q. 'tri.vs[0]' is temporarily stored in 'Q'. */
+    swap2DVertices(tri.vs[0], Q);
+
+    drawFlatTopTriangle(frame, tri);
+
+    /* Retrieve Q and reset triangle. temp now stores Q.*/
+    swap2DVertices(tri.vs[0], Q);
+
+    /*
+        We now draw the top half of the triangle.
+
+        To do this, we substitute the bottom-most vertex and draw the triangle.
+        We also increment the y value of the points on the bottom flat side by one
+        as to prevent that line from being re-drawn, as previously discussed.
+        We can do this by value as the triangle is no longer needed once drawn.
+    */
+    Q[Y]++;
+    tri.vs[1][Y]++;
+
+    swap2DVertices(tri.vs[2], Q);
+
+    drawFlatBottomTriangle(frame, tri);
+
+    /*
+        The triangle drawing is finished.
+
+        If needed, Q could be re-swapped out and decremented below
+        if further manipulation is needed.
+    */
+}
+
+#endif
+
+#if (HALF_SPACE_RASTERISER) || (RASTERISER_BENCHMARK)
+
+    /* Row of the frame array holding a (C style) row of the whole frame. */
+    #if (BANDED_RENDERING)
+        #define HALF_SPACE_FRAME_ROW(row) ( (row) - band_first_row )
     #else
+        #define HALF_SPACE_FRAME_ROW(row) (row)
+    #endif
 
-        /* Sort triangle vertices in ascending order. Triangle will be drawn from the bottom up. */
-        sortTriangle2DVertices(&tri);
+    /*
+        Sets up the edge function of the edge from (x0, row0) to (x1, row1), being the column and row of each vertex in
+        the whole frame with SUBPIXEL_BITS fractional bits: E(x, row) = (x1 - x0)(row - row0) - (row1 - row0)(x - x0).
+        It is 0 on the line through the edge and, if the vertices of a triangle are taken in turn such that its area
+        is positive, positive inside the triangle. a, b and c give E at the centre of the pixel of a whole column and row.
+
+        E is a whole number at pixel centres, so the top-left rule is applied by lowering c by 1 for the edges that are
+        not top or left edges: E >= 0 then holds of pixel centres on a top or left edge but not on the others. As rows
+        count down, the inside of the triangle lies to the right of a left edge, where E grows with x, and below a
+        horizontal top edge.
+    */
+    static HalfSpaceEdge setupHalfSpaceEdge(int16_t x0, int16_t row0, int16_t x1, int16_t row1)
+    {
+        HalfSpaceEdge e;
+        uint8_t top_left = (row0 > row1) || ( (row0 == row1) && (x1 > x0) );
+
+        e.a = (int32_t) (row0 - row1) * (1 << SUBPIXEL_BITS);
+        e.b = (int32_t) (x1 - x0) * (1 << SUBPIXEL_BITS);
+        e.c = -((int32_t) (row0 - row1) * x0) - ((int32_t) (x1 - x0) * row0) - !top_left;
 
-        /* Simple case of top flat triangle only. */
-        if (tri.vs[0][Y] == tri.vs[1][Y]) {
-            drawFlatTopTriangle(frame, tri);
+        return e;
+    }
+
+    static void drawTriangleHalfSpace(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], const Triangle2D *tri)
+    {
+        /*
+            Pixels are addressed by the column and (C style) row of the whole frame, as rows count down whereas y
+            counts up. A pixel is drawn if all three edge functions are at least 0 at its centre, which is tested at
+            once by OR-ing them together as a negative value has its sign bit set.
+
+            As an edge function is linear, its least and greatest values over a block are at the corners picked out
+            by the signs of a and b. These are kept as offsets from its value at the top left pixel of the block,
+            which is stepped by additions from block to block.
+        */
+        int16_t xs[3];
+        int16_t rows[3];
+        int16_t first_x;
+        int16_t last_x;
+        int16_t first_row;
+        int16_t last_row;
+        int16_t first_block_x;
+        int16_t block_x;
+        int16_t block_row;
+        int16_t first_col;
+        int16_t last_col;
+        int16_t row;
+        int16_t row_end;
+        int16_t temp;
+        int32_t area;
+
+        HalfSpaceEdge edges[3];
+        int32_t block_min[3];   /* Least value of each edge function over a block, less that at its top left pixel. */
+        int32_t block_max[3];   /* Greatest value of each edge function over a block, less that at its top left pixel. */
+        int32_t row_e[3];       /* Each edge function at the top left pixel of the first block of the row of blocks. */
+        int32_t block_e[3];     /* Each edge function at the top left pixel of the block. */
+        int32_t pixel_e[3];     /* Each edge function at the pixel. */
+
+        uint8_t pixel_value = tri->colour + (tri->relative_intensity << PIXELS_PER_BYTE);
+        uint8_t pixel_byte = pixel_value + (pixel_value << BITS_PER_PIXEL);
+        uint8_t mask;
+        uint8_t *frame_row;
+
+        for (uint8_t i = 0; i < 3; i++) {
+            xs[i] = tri->vs[i][X];
+            rows[i] = ((FRAME_NUM_ROWS - 1) << SUBPIXEL_BITS) - tri->vs[i][Y];
+        }
+
+        /* Twice the signed area. If negative, the vertices are taken in the other order. */
+        area = ((int32_t) (xs[1] - xs[0]) * (rows[2] - rows[0])) - ((int32_t) (rows[1] - rows[0]) * (xs[2] - xs[0]));
+
+        /* Seen edge on, the triangle covers no area. */
+        if (area == 0) {
             return;
         }
 
-        /* Simple case of bottom flat triangle only. */
-        if (tri.vs[1][Y] == tri.vs[2][Y]) {
-            drawFlatBottomTriangle(frame, tri);
+        if (area < 0) {
+            temp = xs[1];
+            xs[1] = xs[2];
+            xs[2] = temp;
+
+            temp = rows[1];
+            rows[1] = rows[2];
+            rows[2] = temp;
+        }
+
+        /* Bounding box of the vertices, then of the pixel centres within it, clipped to the frame (or band). */
+        first_x = xs[0];
+        last_x = xs[0];
+        first_row = rows[0];
+        last_row = rows[0];
+
+        for (uint8_t i = 1; i < 3; i++) {
+            first_x = (xs[i] < first_x) ? xs[i] : first_x;
+            last_x = (xs[i] > last_x) ? xs[i] : last_x;
+            first_row = (rows[i] < first_row) ? rows[i] : first_row;
+            last_row = (rows[i] > last_row) ? rows[i] : last_row;
+        }
+
+        if ( (last_row < 0) || (last_x < 0) ) {
             return;
         }
 
-        /*
-            General Case. We split the triangle into two - a flat top and a flat bottom. 
-            We then draw both.
+        /* Within the guard band, vertices may lie beyond the near edges of the frame too. */
+        first_x = (first_x < 0) ? 0 : first_x;
+        first_row = (first_row < 0) ? 0 : first_row;
 
-            To do this, we first find the common fourth point. It lies along the hypotenuse
-            and shares an x value with tri.vs[1], if the vertices are sorted correctly as above.
-            To find the y coordinate of this point, we apply Thales' theorem to interpolate
-            the hypotenuse ar this x value. We will call this point Q.
-        */
-        uint8_t Q[2];
+        first_x = (first_x + (1 << SUBPIXEL_BITS) - 1) >> SUBPIXEL_BITS;
+        last_x = last_x >> SUBPIXEL_BITS;
+        first_row = (first_row + (1 << SUBPIXEL_BITS) - 1) >> SUBPIXEL_BITS;
+        last_row = last_row >> SUBPIXEL_BITS;
 
-        /*
-            x_Q = (x_2 - x_0)\frac{y_1 - y_0}{y_2 - y_0} + x_0
-            The float divide is rounded as opposed to truncated as of course, with an
-            extremal point like Q, the importance of rounding up is that much higher.
+        #if (BANDED_RENDERING)
+            first_row = (first_row < band_first_row) ? band_first_row : first_row;
+            last_row = (last_row > band_first_row + BAND_NUM_ROWS - 1) ? band_first_row + BAND_NUM_ROWS - 1 : last_row;
+        #else
+            last_row = (last_row > FRAME_NUM_ROWS - 1) ? FRAME_NUM_ROWS - 1 : last_row;
+        #endif
 
-            Value found is incremented by 0.5 such that the casting process preforms a rounding operation.
-        */
-        Q[X] = (uint8_t) ( tri.vs[0][X] + (tri.vs[2][X] - tri.vs[0][X]) * ( ( (float) (tri.vs[1][Y] - tri.vs[0][Y]) / (float) (tri.vs[2][Y] - tri.vs[0][Y]) ) ) + 0.5);
-        Q[Y] = tri.vs[1][Y];
+        last_x = (last_x > FRAME_NUM_COLS - 1) ? FRAME_NUM_COLS - 1 : last_x;
 
-        /*
-            We first draw the bottom half, being the top flat triangle.
+        if ( (first_row > last_row) || (first_x > last_x) ) {
+            return;
+        }
 
-            In doing this, we also INCLUDE the horizontal line at Q[Y]. We don't
-            include this during the drawing of the top half as it doesn't need to be drawn
-            twice.
+        /* Blocks are aligned to the frame, so the first may start before the bounding box. */
+        first_block_x = first_x - (first_x % HALF_SPACE_BLOCK_COLS);
+        block_row = first_row - (first_row % HALF_SPACE_BLOCK_ROWS);
 
-            Following the sorting of the triangle vertices, we must temporarily
-            substitute Q for the top-most vertex. We then draw the resulting top-flat triangle.
-        */
+        for (uint8_t i = 0; i < 3; i++) {
+            edges[i] = setupHalfSpaceEdge(xs[i], rows[i], xs[(i + 1) % 3], rows[(i + 1) % 3]);
 
-        /* Substitute in Q. 'tri.vs[0]' is temporarily stored in 'Q'. */
-        swap2DVertices(tri.vs[0], Q);
+            block_min[i] = ((edges[i].a < 0) ? edges[i].a * (HALF_SPACE_BLOCK_COLS - 1) : 0) +
+                ((edges[i].b < 0) ? edges[i].b * (HALF_SPACE_BLOCK_ROWS - 1) : 0);
+            block_max[i] = ((edges[i].a > 0) ? edges[i].a * (HALF_SPACE_BLOCK_COLS - 1) : 0) +
+                ((edges[i].b > 0) ? edges[i].b * (HALF_SPACE_BLOCK_ROWS - 1) : 0);
 
-        drawFlatTopTriangle(frame, tri);
+            row_e[i] = (edges[i].a * first_block_x) + (edges[i].b * block_row) + edges[i].c;
+        }
 
-        /* Retrieve Q and reset triangle. temp now stores Q.*/
-        swap2DVertices(tri.vs[0], Q);
+        for (; block_row <= last_row; block_row += HALF_SPACE_BLOCK_ROWS) {
 
-        /*
-            We now draw the top half of the triangle.
+            for (uint8_t i = 0; i < 3; i++) {
+                block_e[i] = row_e[i];
+            }
 
-            To do this, we substitute the bottom-most vertex and draw the triangle.
-            We also increment the y value of the points on the bottom flat side by one
-            as to prevent that line from being re-drawn, as previously discussed.
-            We can do this by value as the triangle is no longer needed once drawn.
-        */
-        Q[Y]++;
-        tri.vs[1][Y]++;
+            for (block_x = first_block_x; block_x <= last_x; block_x += HALF_SPACE_BLOCK_COLS) {
+
+                /* Blocks lying wholly outside of an edge are skipped. */
+                if ( ((block_e[0] + block_max[0]) | (block_e[1] + block_max[1]) | (block_e[2] + block_max[2])) >= 0 ) {
+
+                    /* Block lies wholly inside all three edges and within the bounding box, so is filled a byte at a time. */
+                    if ( (((block_e[0] + block_min[0]) | (block_e[1] + block_min[1]) | (block_e[2] + block_min[2])) >= 0) &&
+                        (block_x >= first_x) && (block_x + HALF_SPACE_BLOCK_COLS - 1 <= last_x) &&
+                        (block_row >= first_row) && (block_row + HALF_SPACE_BLOCK_ROWS - 1 <= last_row) ) {
+
+                        for (row = block_row; row < block_row + HALF_SPACE_BLOCK_ROWS; row++) {
+                            #if (INTERLACED)
+                                /* Row does not lie in the current field. */
+                                if (!ROW_IN_FIELD(row)) {
+                                    continue;
+                                }
+                            #endif
+
+                            frame_row = frame[HALF_SPACE_FRAME_ROW(row)] + (block_x / PIXELS_PER_BYTE);
+
+                            COUNT_PIXEL_WRITES(HALF_SPACE_FRAME_ROW(row), block_x, block_x + HALF_SPACE_BLOCK_COLS - 1);
+
+                            for (uint8_t byte = 0; byte < HALF_SPACE_BLOCK_COLS / PIXELS_PER_BYTE; byte++) {
+                                frame_row[byte] = pixel_byte;
+                            }
+                        }
+
+                    /*
+                        An edge crosses the block, or it is clipped, so each pixel of it within the bounding box is tested.
+                        The two pixels of each byte are tested together and the byte written once.
+                    */
+                    } else {
+                        first_col = (block_x < (first_x & ~1)) ? (first_x & ~1) : block_x;
+                        last_col = (block_x + HALF_SPACE_BLOCK_COLS - 1 > (last_x | 1)) ? (last_x | 1) : block_x + HALF_SPACE_BLOCK_COLS - 1;
+                        row = (block_row < first_row) ? first_row : block_row;
+                        row_end = (block_row + HALF_SPACE_BLOCK_ROWS - 1 > last_row) ? last_row : block_row + HALF_SPACE_BLOCK_ROWS - 1;
+
+                        for (; row <= row_end; row++) {
+                            #if (INTERLACED)
+                                /* Row does not lie in the current field. */
+                                if (!ROW_IN_FIELD(row)) {
+                                    continue;
+                                }
+                            #endif
+
+                            frame_row = frame[HALF_SPACE_FRAME_ROW(row)];
+
+                            for (uint8_t i = 0; i < 3; i++) {
+                                pixel_e[i] = block_e[i] + (edges[i].a * (first_col - block_x)) + (edges[i].b * (row - block_row));
+                            }
+
+                            for (int16_t col = first_col; col <= last_col; col += PIXELS_PER_BYTE) {
+                                /* Bits of the byte that are drawn, those of the even (low) and of the odd (high) pixel. */
+                                mask = ((pixel_e[0] | pixel_e[1] | pixel_e[2]) >= 0) ? PIXEL_BITMASK : 0;
+
+                                pixel_e[0] += edges[0].a;
+                                pixel_e[1] += edges[1].a;
+                                pixel_e[2] += edges[2].a;
+
+                                mask |= ((pixel_e[0] | pixel_e[1] | pixel_e[2]) >= 0) ? (PIXEL_BITMASK << BITS_PER_PIXEL) : 0;
+
+                                pixel_e[0] += edges[0].a;
+                                pixel_e[1] += edges[1].a;
+                                pixel_e[2] += edges[2].a;
+
+                                if (mask) {
+                                    frame_row[col / PIXELS_PER_BYTE] = (frame_row[col / PIXELS_PER_BYTE] & ~mask) | (pixel_byte & mask);
+
+                                    if (mask & PIXEL_BITMASK) {
+                                        COUNT_PIXEL_WRITES(HALF_SPACE_FRAME_ROW(row), col, col);
+                                    }
+
+                                    if (mask >> BITS_PER_PIXEL) {
+                                        COUNT_PIXEL_WRITES(HALF_SPACE_FRAME_ROW(row), col + 1, col + 1);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
 
-        swap2DVertices(tri.vs[2], Q);
+                for (uint8_t i = 0; i < 3; i++) {
+                    block_e[i] += edges[i].a * HALF_SPACE_BLOCK_COLS;
+                }
+            }
 
-        drawFlatBottomTriangle(frame, tri);
+            for (uint8_t i = 0; i < 3; i++) {
+                row_e[i] += edges[i].b * HALF_SPACE_BLOCK_ROWS;
+            }
+        }
+    }
 
-        /*
-            The triangle drawing is finished.
+#endif
 
-            If needed, Q could be re-swapped out and decremented below
-            if further manipulation is needed.
+#if (RASTERISER_BENCHMARK)
+    void printRasteriserBenchmark(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS])
+    {
+        /*
+            Each size below is the width and height of a triangle, clipped to the frame. Its third vertex lies a third
+            of the way across its top, such that the span rasteriser splits it in two. Each triangle is drawn
+            RASTERISER_BENCHMARK_REPEATS times by the span rasteriser and then by the half-space rasteriser, from
+            small to as large as the frame and from square to wide, tall and thin.
         */
+        #define RASTERISER_BENCHMARK_REPEATS 1000
+
+        static const uint8_t sizes[][2] =
+        {
+            {4, 4}, {8, 8}, {16, 16}, {32, 32},
+            {32, 8}, {8, 32}, {32, 2}, {2, 32}
+        };
+
+        Triangle2D tri;
+        uint8_t width;
+        uint8_t height;
+        uint16_t num_pixels;
+        uint32_t start_milliseconds;
+        uint32_t spans_milliseconds;
+        uint32_t half_space_milliseconds;
+
+        tri.colour = R;
+        tri.relative_intensity = MAX_RELATIVE_INTENSITY;
+
+        for (uint8_t size = 0; size < sizeof(sizes) / sizeof(sizes[0]); size++) {
+            width = (sizes[size][X] > FRAME_NUM_COLS - 1) ? FRAME_NUM_COLS - 1 : sizes[size][X];
+            height = (sizes[size][Y] > FRAME_NUM_ROWS - 1) ? FRAME_NUM_ROWS - 1 : sizes[size][Y];
+
+            tri.vs[0][X] = 0;
+            tri.vs[0][Y] = 0;
+            tri.vs[1][X] = width;
+            tri.vs[1][Y] = height / 3;
+            tri.vs[2][X] = width / 3;
+            tri.vs[2][Y] = height;
+
+            start_milliseconds = OSA_TimeGetMsec();
+            for (uint16_t i = 0; i < RASTERISER_BENCHMARK_REPEATS; i++) {
+                drawTriangleSpans(frame, tri);
+            }
+            spans_milliseconds = OSA_TimeGetMsec() - start_milliseconds;
+
+            RESET_FRAME(frame);
+
+            start_milliseconds = OSA_TimeGetMsec();
+            for (uint16_t i = 0; i < RASTERISER_BENCHMARK_REPEATS; i++) {
+                drawTriangleHalfSpace(frame, &tri);
+            }
+            half_space_milliseconds = OSA_TimeGetMsec() - start_milliseconds;
+
+            num_pixels = 0;
+            for (uint8_t row = 0; row < FRAME_NUM_ROWS; row++) {
+                for (uint8_t col = 0; col < FRAME_NUM_COLS; col++) {
+                    num_pixels += (get_pixel_value_rowcol(frame, row, col) != 0);
+                }
+            }
+
+            RESET_FRAME(frame);
+
+            /* Division can be truncated safely. */
+            warpPrint("Triangle %dx%d, %d pixels: spans %dus, half-space %dus.\n",
+                width, height, num_pixels,
+                spans_milliseconds * (1000 / RASTERISER_BENCHMARK_REPEATS),
+                half_space_milliseconds * (1000 / RASTERISER_BENCHMARK_REPEATS));
+        }
+    }
+#endif
+
+#if (DIRTY_RECTANGLES)
+
+    /* Grows frame_dirty_rect to cover the bounding box of the triangle, which covers every pixel drawn. */
+    static void markTriangleDirty(const Triangle2D *tri)
+    {
+        #if (GUARD_BAND_RASTERISING)
+            int16_t x;
+            int16_t row;
+        #else
+            uint8_t x;
+            uint8_t row;
+        #endif
+
+        for (uint8_t i = 0; i < 3; i++) {
+            x = VERTEX_PIXEL(tri->vs[i][X]);
+
+            /* Rows are counted from the top of the frame whereas y is counted from the bottom. */
+            row = FRAME_ROW(VERTEX_PIXEL(tri->vs[i][Y]));
+
+            #if (GUARD_BAND_RASTERISING)
+                /* Vertices may lie off the frame, within the guard band. */
+                x = (x < 0) ? 0 : ( (x > FRAME_NUM_COLS - 1) ? FRAME_NUM_COLS - 1 : x );
+                row = (row < 0) ? 0 : ( (row > FRAME_NUM_ROWS - 1) ? FRAME_NUM_ROWS - 1 : row );
+            #endif
+
+            if (x < frame_dirty_rect.first_col) {
+                frame_dirty_rect.first_col = x;
+            }
+
+            if (x > frame_dirty_rect.last_col) {
+                frame_dirty_rect.last_col = x;
+            }
+
+            if (row < frame_dirty_rect.first_row) {
+                frame_dirty_rect.first_row = row;
+            }
 
+            if (row > frame_dirty_rect.last_row) {
+                frame_dirty_rect.last_row = row;
+            }
+        }
+    }
+
+#endif
+
+void drawTriangle(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], Triangle2D tri)
+{
+    #if (DIRTY_RECTANGLES)
+        markTriangleDirty(&tri);
     #endif
-}
\ No newline at end of file
+
+    #if (DIRECT_RENDERING)
+        directTriangles++;
+    #endif
+
+    #if (WIREFRAME)
+
+        #if (HW_PRIMITIVES)
+            /* As drawLine(), the edges are drawn at maximum intensity. */
+            hwDrawLine(tri.vs[0], tri.vs[1], tri.colour + (MAX_RELATIVE_INTENSITY << PIXELS_PER_BYTE));
+            hwDrawLine(tri.vs[1], tri.vs[2], tri.colour + (MAX_RELATIVE_INTENSITY << PIXELS_PER_BYTE));
+            hwDrawLine(tri.vs[2], tri.vs[0], tri.colour + (MAX_RELATIVE_INTENSITY << PIXELS_PER_BYTE));
+        #else
+            drawLine(frame, tri.vs[0], tri.vs[1], tri.colour, tri.relative_intensity);
+            drawLine(frame, tri.vs[1], tri.vs[2], tri.colour, tri.relative_intensity);
+            drawLine(frame, tri.vs[2], tri.vs[0], tri.colour, tri.relative_intensity);
+        #endif
+
+    #else
+
+        #if (HALF_SPACE_RASTERISER)
+            drawTriangleHalfSpace(frame, &tri);
+        #else
+            drawTriangleSpans(frame, tri);
+        #endif
+
+    #endif
+}
+
+void drawClippedPolygon(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], const VertexCoord polygon[][2], uint8_t num_vertices, Triangle2D *tri)
+{
+    for (uint8_t i = 0; i + 2 < num_vertices; i++) {
+        clip_fan_triangle(polygon, i, tri);
+        drawTriangle(frame, *tri);
+    }
+}
@@ -16,6 +16,13 @@ typedef struct {
     int16_t err;        /* Pixel Error term. (p - dx) for octant 0, (p - dy) for octant 1. */
 } TriangleSideVarTracker;
 
+/* Edge function of a triangle edge for the half-space rasteriser, E(x, row) = (a * x) + (b * row) + c. */
+typedef struct {
+    int32_t a;  /* Step in E per column. */
+    int32_t b;  /* Step in E per row. */
+    int32_t c;
+} HalfSpaceEdge;
+
 /*
     Draws and fills triangles in one colour.
 
@@ -27,5 +34,22 @@ typedef struct {
     Further documentation on Bresenham's line algorithm and its implementation here is given among
     the drawLine function which was a precursor to the drawTriangle function. The drawLine function was
     adapted from an implementation by Michael Abrash.
+
+    With HALF_SPACE_RASTERISER, triangles are instead filled block by block from their edge functions, see
+    graphics.h.
+*/
+void drawTriangle(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], Triangle2D tri);
+
+/*
+    Draws the polygon of num_vertices vertices clipped by clip_triangle() as a fan of triangles, in the colour and
+    relative intensity of tri. The vertices of tri are overwritten.
 */
-void drawTriangle(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], Triangle2D tri);
\ No newline at end of file
+void drawClippedPolygon(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], const VertexCoord polygon[][2], uint8_t num_vertices, Triangle2D *tri);
+
+#if (RASTERISER_BENCHMARK)
+    /*
+        Prints the time per triangle taken by the span and the half-space rasterisers over triangles of several sizes
+        and aspect ratios, drawn in frame. The frame is cleared afterwards.
+    */
+    void printRasteriserBenchmark(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS]);
+#endif
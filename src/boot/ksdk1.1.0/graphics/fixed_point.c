@@ -0,0 +1,46 @@
+#include <stdint.h>
+
+#include "fixed_point.h"
+
+FixedQ16 fixed_mul_q16(FixedQ16 a, FixedQ16 b)
+{
+    return (FixedQ16) ( ( ((int64_t) a * (int64_t) b) + FIXED_Q16_HALF ) >> FIXED_Q16_FRACTIONAL_BITS );
+}
+
+FixedQ8 fixed_mul_q8(FixedQ8 a, FixedQ8 b)
+{
+    return (FixedQ8) ( ( ((int32_t) a * (int32_t) b) + FIXED_Q8_HALF ) >> FIXED_Q8_FRACTIONAL_BITS );
+}
+
+FixedQ16 fixed_mul_q8_q16(FixedQ8 coeff, FixedQ16 value)
+{
+    return ( ((int32_t) coeff * value) + FIXED_Q8_HALF ) >> FIXED_Q8_FRACTIONAL_BITS;
+}
+
+FixedQ16 fixed_mul_div_q16(FixedQ16 a, FixedQ16 b, FixedQ16 c)
+{
+    /* The implied binary points of the product and the divisor cancel, leaving that of the result. */
+    return (FixedQ16) ( ((int64_t) a * (int64_t) b) / c );
+}
+
+FixedQ16 fixed_reciprocal_q16(FixedQ16 a)
+{
+    /*
+        1 / a in Q16.16 is 2^32 / a_raw. 2^32 does not fit in 32 bits so 2^32 - 1 is used,
+        adding half the divisor beforehand would overflow so the result is truncated. The error
+        is at most one least significant bit.
+    */
+    return (FixedQ16) ( 0xFFFFFFFFUL / (uint32_t) a );
+}
+
+FixedQ16 dot_product_fixed_3d(const FixedVec3 vec1, const FixedVec3 vec2)
+{
+    return fixed_mul_q16(vec1[0], vec2[0]) + fixed_mul_q16(vec1[1], vec2[1]) + fixed_mul_q16(vec1[2], vec2[2]);
+}
+
+void cross_product_fixed_3d(const FixedVec3 vec1, const FixedVec3 vec2, FixedVec3 result)
+{
+    result[0] = fixed_mul_q16(vec1[1], vec2[2]) - fixed_mul_q16(vec1[2], vec2[1]);
+    result[1] = fixed_mul_q16(vec1[2], vec2[0]) - fixed_mul_q16(vec1[0], vec2[2]);
+    result[2] = fixed_mul_q16(vec1[0], vec2[1]) - fixed_mul_q16(vec1[1], vec2[0]);
+}
@@ -0,0 +1,77 @@
+#ifndef STDINT
+	#include <stdint.h>
+	#define STDINT
+#endif
+
+/*
+    Fixed point arithmetic for the geometry pipeline.
+
+    The Cortex-M0+ in the KL03 has no FPU so every float operation is emulated in software,
+    costing tens of cycles each. The types below are plain integers with an implied binary point
+    such that the hardware integer multiplier can be used instead.
+
+    FixedQ16 is a signed Q16.16 number. That is, the top 16 bits are the integer part and the
+    bottom 16 bits are the fractional part. It is used for coordinates, normals and anything
+    else that needs the range of a few units with sub-pixel precision.
+
+    FixedQ8 is a signed Q8.8 number. It is used for matrix coefficients such as sines and cosines.
+    The sine lookup table only has 7 fractional bits of precision so Q8.8 represents it exactly.
+    The benefit is that a Q8.8 multiplied by a Q16.16 fits in 32 bits provided that the magnitude of
+    the true product is less than 128, so no 64 bit multiply is needed in the rotation hot path.
+*/
+typedef int32_t FixedQ16;
+typedef int16_t FixedQ8;
+
+#define FIXED_Q16_FRACTIONAL_BITS 16
+#define FIXED_Q8_FRACTIONAL_BITS 8
+
+#define FIXED_Q16_ONE ( (FixedQ16) 1 << FIXED_Q16_FRACTIONAL_BITS )
+#define FIXED_Q16_HALF ( FIXED_Q16_ONE >> 1 )
+#define FIXED_Q8_ONE ( (FixedQ8) 1 << FIXED_Q8_FRACTIONAL_BITS )
+#define FIXED_Q8_HALF ( FIXED_Q8_ONE >> 1 )
+
+/*
+    Conversions from floating point constants. These are rounded to the nearest representable value
+    and are intended for compile time constants only (the compiler evaluates them) such that no
+    floating point code is emitted.
+*/
+#define FIXED_Q16_FROM_FLOAT(f) \
+    ( (FixedQ16) ( ((f) >= 0) ? ((f) * 65536.0 + 0.5) : ((f) * 65536.0 - 0.5) ) )
+
+#define FIXED_Q8_FROM_FLOAT(f) \
+    ( (FixedQ8) ( ((f) >= 0) ? ((f) * 256.0 + 0.5) : ((f) * 256.0 - 0.5) ) )
+
+#define FIXED_Q16_FROM_INT(i) \
+    ( (FixedQ16) (i) << FIXED_Q16_FRACTIONAL_BITS )
+
+/* Only to be used for debugging and host side comparisons. Pulls in soft-float on the target. */
+#define FIXED_Q16_TO_FLOAT(q) \
+    ( (float) (q) / 65536.0f )
+
+/* A three-dimensional vector of Q16.16 values. */
+typedef FixedQ16 FixedVec3[3];
+
+/* Multiplies two Q16.16 numbers with rounding. Uses a 64 bit intermediate so any Q16.16 values may be passed. */
+FixedQ16 fixed_mul_q16(FixedQ16 a, FixedQ16 b);
+
+/* Multiplies two Q8.8 numbers with rounding. */
+FixedQ8 fixed_mul_q8(FixedQ8 a, FixedQ8 b);
+
+/* Multiplies a Q16.16 number by a Q8.8 coefficient with rounding, in 32 bits. See above for the range limit. */
+FixedQ16 fixed_mul_q8_q16(FixedQ8 coeff, FixedQ16 value);
+
+/* Returns a * b / c, rounded towards 0, with a 64 bit intermediate. The result must fit in Q16.16. */
+FixedQ16 fixed_mul_div_q16(FixedQ16 a, FixedQ16 b, FixedQ16 c);
+
+/*
+    Returns 1 / a in Q16.16. Uses a single unsigned 32 bit divide, which is far cheaper than the
+    64 bit divide a general Q16.16 division would need. 'a' must be positive and greater than
+    2^-15 such that the result fits. In the pipeline it is used for the perspective divide, where 'a' is z.
+*/
+FixedQ16 fixed_reciprocal_q16(FixedQ16 a);
+
+/* Returns simple dot product between two fixed point vectors. */
+FixedQ16 dot_product_fixed_3d(const FixedVec3 vec1, const FixedVec3 vec2);
+
+/* Calculates simple cross product between two fixed point vectors, stores answer in result. */
+void cross_product_fixed_3d(const FixedVec3 vec1, const FixedVec3 vec2, FixedVec3 result);
@@ -1,6 +1,31 @@
 #include <stdint.h>
 
-#include "graphics.h"
+#ifndef GRAPHICS
+    #include "graphics.h"
+    #define GRAPHICS
+#endif
+
+#include "display.h"
+
+#if (DISPLAY_VTABLE) && (DISPLAY_BACKEND == DISPLAY_SSD1331)
+    const DisplayBackend *display = &ssd1331Display;
+#elif (DISPLAY_VTABLE) && (DISPLAY_BACKEND == DISPLAY_SSD1306)
+    const DisplayBackend *display = &ssd1306Display;
+#elif (DISPLAY_VTABLE) && (DISPLAY_BACKEND == DISPLAY_HOST)
+    const DisplayBackend *display = &hostDisplay;
+#endif
+
+#if (BANDED_RENDERING)
+    uint8_t band_first_row = 0;
+#endif
+
+#if (INTERLACED)
+    uint8_t frame_field = FIELD_ALL_ROWS;
+#endif
+
+#if (DIRTY_RECTANGLES)
+    DirtyRect frame_dirty_rect = {FRAME_NUM_ROWS, 0, FRAME_NUM_COLS, 0}; /* Empty. */
+#endif
 
 void drawPixel(
     uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS],
@@ -11,15 +36,38 @@ void drawPixel(
 )
 {
     uint8_t shift = BITS_PER_PIXEL * (x % PIXELS_PER_BYTE);
+    uint8_t row = FRAME_ROW(y);
+
+    #if (DIRECT_RENDERING)
+        /* Sent straight to the display as a span of one pixel. */
+        directDrawSpan(y, x, x, colour + (relative_intensity << PIXELS_PER_BYTE));
+        return;
+    #endif
+
+    #if (BANDED_RENDERING)
+        /* Pixel does not lie in the current band. */
+        if (row >= BAND_NUM_ROWS) {
+            return;
+        }
+    #endif
+
+    #if (INTERLACED)
+        /* Pixel does not lie in the current field. */
+        if (!ROW_IN_FIELD(FRAME_NUM_ROWS - y - 1)) {
+            return;
+        }
+    #endif
+
+    COUNT_PIXEL_WRITES(row, x, x);
 
     /*
         Write colour and intensity to pixel in one operation to pixel.
         To ensure pixels are overwritten correctly, we have to set the correct byte to 0 first.
     */
 
-    frame[FRAME_NUM_ROWS - y - 1][x / PIXELS_PER_BYTE]
+    frame[row][x / PIXELS_PER_BYTE]
         +=
-        ( -1 * (frame[FRAME_NUM_ROWS - y - 1][x / PIXELS_PER_BYTE] & (PIXEL_BITMASK << shift) ) )   /* Extract and remove current pixel value (usually 0). */
+        ( -1 * (frame[row][x / PIXELS_PER_BYTE] & (PIXEL_BITMASK << shift) ) )   /* Extract and remove current pixel value (usually 0). */
         + ( (colour << shift) + ( (relative_intensity << PIXELS_PER_BYTE) << shift ) );             /* Add new pixel value. */
 }
 
@@ -27,7 +75,7 @@ uint8_t get_pixel_value_xy(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], uint
 {
     uint8_t shift = BITS_PER_PIXEL * (x % PIXELS_PER_BYTE);
 
-    return ( ( frame[FRAME_NUM_ROWS - y - 1][x / PIXELS_PER_BYTE] & (PIXEL_BITMASK << shift) ) >> shift );
+    return ( ( frame[FRAME_ROW(y)][x / PIXELS_PER_BYTE] & (PIXEL_BITMASK << shift) ) >> shift );
 }
 
 uint8_t get_pixel_value_rowcol(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], uint8_t row, uint8_t col)
@@ -49,3 +97,22 @@ void cross_product_float_3d(float vec1[3], float vec2[3], float result[3])
     result[Z] = (vec1[X] * vec2[Y]) - (vec1[Y] * vec2[X]);
 }
 
+void mat3_mul_vec3(const Mat3 *mat, const Scalar vec[3], Scalar result[3])
+{
+    for (uint8_t i = 0; i < 3; i++) {
+        result[i] = SCALAR_COEFF_MUL_SCALAR(mat->m[i][X], vec[X])
+                  + SCALAR_COEFF_MUL_SCALAR(mat->m[i][Y], vec[Y])
+                  + SCALAR_COEFF_MUL_SCALAR(mat->m[i][Z], vec[Z]);
+    }
+}
+
+void mat3_mul_mat3(const Mat3 *mat1, const Mat3 *mat2, Mat3 *result)
+{
+    for (uint8_t i = 0; i < 3; i++) {
+        for (uint8_t j = 0; j < 3; j++) {
+            result->m[i][j] = SCALAR_COEFF_MUL(mat1->m[i][X], mat2->m[X][j])
+                            + SCALAR_COEFF_MUL(mat1->m[i][Y], mat2->m[Y][j])
+                            + SCALAR_COEFF_MUL(mat1->m[i][Z], mat2->m[Z][j]);
+        }
+    }
+}
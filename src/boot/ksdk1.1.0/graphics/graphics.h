@@ -3,6 +3,11 @@
 	#define STDINT
 #endif
 
+#ifndef FIXED_POINT
+	#include "fixed_point.h"
+	#define FIXED_POINT
+#endif
+
 /*=================== START OF DEMO SELECTION ======================*/
 
 /*
@@ -29,37 +34,60 @@
     Optimisation prevents printing as the print buffer is no longer used.
 */
 
+/*
+    Render scale. Must be 1, 2 or 3.
+
+    Each pixel of the frame is shown as a RENDER_SCALE x RENDER_SCALE block of the screen. writeFrame() replicates the
+    pixels as it sends them, so the frame array and the rasterisation stay those of FRAME_NUM_ROWS x FRAME_NUM_COLS.
+    At 1, the demos render a 36x36 frame in the centre of the screen. Above 1, they render the largest frame with even
+    sides that fits on the screen, SCALED_SCREEN_ROWS x SCALED_SCREEN_COLS. That is 32x48 (768 bytes) at 2, covering
+    the whole screen, and 20x32 (320 bytes) at 3, leaving 4 rows blank. The projection maps the field of view onto the
+    frame (see projection.h), so the scene spans the frame whatever its size.
+
+    Not supported with scanline rendering or hardware primitives.
+*/
+#define RENDER_SCALE 1
+
+#define SCALED_SCREEN_ROWS ( (SCREEN_MAX_ROWS / RENDER_SCALE) & ~1 )
+#define SCALED_SCREEN_COLS ( (SCREEN_MAX_COLS / RENDER_SCALE) & ~1 )
+
 #if (SPINNING_SQUARE_DEMO)
-    #define FRAME_NUM_ROWS 36
-    #define FRAME_NUM_COLS 36
+    #define FRAME_NUM_ROWS ( (RENDER_SCALE == 1) ? 36 : SCALED_SCREEN_ROWS )
+    #define FRAME_NUM_COLS ( (RENDER_SCALE == 1) ? 36 : SCALED_SCREEN_COLS )
     #define OUTER_FRAME 0 /* Used to display a square outline to display the limits of the frame on the OLED display. 1 for yes, 0 for no. */
     #define L 0.7 /* Square side length. Short variable name for later clarity. */
     #define NUM_TRIANGLES 2
+    #define NUM_VERTICES 4
+    #define VERTEX_CACHE_SIZE NUM_VERTICES /* Unique vertices transformed per frame, see mesh.h. */
     #define GRAPHICS_OPTIMISED 0
     #define ROTATION_RATE_THETA 6 /* Must be integer. */
     #define ROTATION_RATE_PHI 0   /* Must be integer. */
     #define NUM_ROTATIONS 20
 
 #elif (SPINNING_MULTICOLOUR_CUBE_DEMO)
-    #define FRAME_NUM_ROWS 36
-    #define FRAME_NUM_COLS 36
+    #define FRAME_NUM_ROWS ( (RENDER_SCALE == 1) ? 36 : SCALED_SCREEN_ROWS )
+    #define FRAME_NUM_COLS ( (RENDER_SCALE == 1) ? 36 : SCALED_SCREEN_COLS )
     #define OUTER_FRAME 0 /* Used to display a square outline to display the limits of the frame on the OLED display. 1 for yes, 0 for no. */
     #define L 0.56 /* Cube side length. Short variable name for later clarity. */
     #define NUM_TRIANGLES 12
+    #define NUM_VERTICES 8
+    #define VERTEX_CACHE_SIZE NUM_VERTICES /* Unique vertices transformed per frame, see mesh.h. */
     #define GRAPHICS_OPTIMISED 0
     #define ROTATION_RATE_THETA 3 /* Must be integer. */
     #define ROTATION_RATE_PHI 7   /* Must be integer. */
     #define NUM_ROTATIONS 20
 
 #elif (TRIANGLES_VS_FRAMERATE_DEMO)
-    #define FRAME_NUM_ROWS 36
-    #define FRAME_NUM_COLS 36
+    #define FRAME_NUM_ROWS ( (RENDER_SCALE == 1) ? 36 : SCALED_SCREEN_ROWS )
+    #define FRAME_NUM_COLS ( (RENDER_SCALE == 1) ? 36 : SCALED_SCREEN_COLS )
     #define GRAPHICS_OPTIMISED 0
     #define OUTER_FRAME 0 /* Used to display a square outline to display the limits of the frame on the OLED display. 1 for yes, 0 for no. */
 
     #define ROTATION_RATE_THETA 0 /* Must be integer. */
     #define ROTATION_RATE_PHI 0   /* Must be integer. */
 
+    #define VERTEX_CACHE_SIZE 3 /* Not used, the triangles in this demo are transformed one by one. */
+
     #define START_TRIANGLES 30
     #define END_TRIANGLES 300
     #define STEP_TRIANGLES 30
@@ -70,6 +98,301 @@
 /* Used to display wireframe triangles - useful for debugging. 1 for yes, 0 for no. */
 #define WIREFRAME 0
 
+/*
+    Fill the horizontal spans of triangles a byte (two pixels) or a word (eight pixels) at a time
+    as opposed to calling drawPixel() for every pixel. 1 for yes, 0 for no.
+    The per-pixel path is kept as a reference, it produces an identical frame (checked by the span_fill tests in test/).
+*/
+#define SPAN_FILL 1
+
+/*
+    Half-space rasteriser. 1 for yes, 0 for no.
+
+    drawTriangle() fills triangles from the integer edge functions of their three edges rather than by splitting them
+    into flat top and flat bottom halves traced by Bresenham's algorithm. The bounding box of the triangle is walked
+    in blocks of HALF_SPACE_BLOCK_COLS x HALF_SPACE_BLOCK_ROWS pixels, aligned such that each row of a block is whole
+    bytes. Blocks outside of any edge are skipped, blocks inside all three are filled a byte (two pixels) at a time and
+    only the blocks that an edge crosses are tested pixel by pixel. There is no float divide per triangle.
+
+    A pixel is drawn if its centre lies inside the triangle, or on a top or left edge of it (the top-left rule: an
+    edge with the triangle below it if horizontal, to its right otherwise). Triangles that share an edge then never
+    both draw a pixel on it and leave no gap between them. The Bresenham spans instead often reach a pixel past
+    sloped edges, so triangles are slightly thinner. Triangles seen edge on, of no area, are not drawn. Pixels
+    outside of the frame are clipped rather than written out of bounds.
+
+    RASTERISER_BENCHMARK times both rasterisers at start up over triangles of several sizes and aspect ratios, see
+    printRasteriserBenchmark(). It needs the whole frame array.
+
+    The span rasteriser stays the default. The only timing taken, on an x86 host, had the half-space rasteriser 1.2x
+    to 5x slower over those triangles. There is no figure for the KL03, whose M0+ emulates the float divide of the
+    spans, so that is for RASTERISER_BENCHMARK to settle before the default is changed.
+
+    HALF_SPACE_BLOCK_COLS must be even: 4x4 and 8x2 blocks are both 8 bytes.
+    Not supported with wireframe triangles, scanline rendering or direct rendering, which do not fill triangles
+    into the frame array with drawTriangle().
+*/
+#define HALF_SPACE_RASTERISER 0
+#define HALF_SPACE_BLOCK_COLS 4
+#define HALF_SPACE_BLOCK_ROWS 4
+#define RASTERISER_BENCHMARK 0
+
+/*
+    Sub-pixel vertices, the number of fractional bits (0 to 4) kept of each projected vertex coordinate.
+
+    With 0, project() rounds each vertex to the nearest pixel centre, so the edges of a moving triangle jump by up to
+    half a pixel at a time. With 4, vertices are held to 1/16 of a pixel as VertexCoord
+    (16 bit) in Triangle2D and VertexCache, and the half-space rasteriser samples the true edges at the pixel centres.
+    Where only whole pixels are needed, for dirty rectangles and the binning of bands, VERTEX_PIXEL() is used.
+
+    Only the half-space rasteriser uses the fractional bits, so HALF_SPACE_RASTERISER must be 1 and
+    RASTERISER_BENCHMARK, which also draws with the span rasteriser, 0. It stays 0 with the span rasteriser the
+    default, which leaves pixels drawn twice and the odd crack along the edges that triangles share. The host display
+    counts both, see display_host.h.
+*/
+#define SUBPIXEL_BITS 0
+
+/*
+    Screen-space clipping of projected triangles. 1 for yes, 0 for no.
+
+    With 0, project_vertex() clamps each vertex into the frame on its own, so a triangle partly off the frame is
+    distorted and one wholly off it is squashed against its edge and still drawn. With 1, vertices are projected to
+    ScreenCoord, signed 16 bit coordinates that may lie off the frame, within a guard band of GUARD_BAND_LIMIT
+    about its centre. Each triangle not culled, so never a face turned away, is then classified by the outcodes of
+    its vertices, the edges of the frame beyond which they lie, by clip_triangle(). Those wholly beyond one edge are
+    rejected and those wholly inside are drawn as they are.
+
+    The half-space rasteriser clips its bounding box to the frame, so draws triangles that straddle an edge as they
+    are, from anywhere in the guard band, and no triangle needs a real clip. For the other rasterisers, which need
+    vertices in the frame, only those triangles are clipped and drawn as a fan. Only vertices very close to the
+    plane of the camera project beyond the guard band, and they are saturated to it rather than wrapping around.
+
+    GUARD_BAND_LIMIT is in 1/2^SUBPIXEL_BITS pixels. It is the largest for which the products of the differences
+    of two coordinates, when clipping and rasterising, fit in 32 bits.
+
+    Wireframe triangles show the edges of the fan that a clipped triangle is drawn as. Not supported with the
+    rasteriser benchmark, which draws the same triangles with both rasterisers.
+*/
+#define SCREEN_CLIPPING 0
+#define GUARD_BAND_LIMIT (1 << 13)
+
+/*
+    Clipping of camera space triangles to the near plane, z = NEAR_PLANE_Z, and to the far plane, z = FAR_PLANE_Z,
+    before the perspective divide. 1 for yes, 0 for no.
+
+    Without NEAR_PLANE_CLIPPING, every vertex must lie well in front of the camera (see model_view_translate()),
+    as the divide by z is undefined at z <= 0. With it, triangles wholly nearer than the near plane are rejected
+    from the z of their vertices alone, before they are projected or their normals found. Triangles that cross it
+    are clipped into a polygon of up to 4 vertices by clip_triangle_depth(), whose new vertices are projected and
+    which is drawn as a fan of 1 or 2 triangles. FAR_PLANE_CLIPPING does the same for triangles beyond the far
+    plane, such that distant geometry costs nothing.
+
+    NEAR_PLANE_Z must be positive and, in the fixed point pipeline, at least 2^-15. The nearer it is, the further
+    off the frame clipped vertices may project, see SCREEN_CLIPPING. Only supported by the mesh demos.
+*/
+#define NEAR_PLANE_CLIPPING 0
+#define NEAR_PLANE_Z 0.25
+#define FAR_PLANE_CLIPPING 0
+#define FAR_PLANE_Z 16.0
+
+#define DEPTH_CLIPPING ( (NEAR_PLANE_CLIPPING) || (FAR_PLANE_CLIPPING) )
+
+/*
+    Face culling by the projected vertices of a triangle. 1 for yes, 0 for no.
+
+    With 0, the mesh demos find the normal of every triangle, a cross product, and cull by the sign of its dot
+    product with a vertex. With 1, they cull by the sign of the signed area of the projected triangle, in integer
+    arithmetic, which is the same but for rounding, and only find the normals of the triangles that are drawn, to
+    shade them. The winding is then that of the triangle as rasterised, so a triangle seen nearly edge on is never
+    drawn from behind. Either way a triangle is culled whole, before it is clipped to the frame, so the two cull
+    the same triangles but for those within the rounding of the projection of edge on.
+
+    Clamped to the frame, the vertices of a triangle partly off it may wind the other way, so SCREEN_CLIPPING must be 1.
+*/
+#define SCREEN_SPACE_CULLING 0
+
+/*
+    Selects the arithmetic used by the geometry pipeline (model-view transform, find_triangle_normal, project).
+    1 uses the integer Q16.16 and Q8.8 types defined in fixed_point.h, 0 uses single precision float which
+    the FPU-less Cortex-M0+ emulates in software. The float path is kept as a reference, and the fixed_point test
+    in test/ checks the error of the fixed point one against it: at most 0.0022 in a camera space vertex and a
+    pixel in a projected one.
+*/
+#define FIXED_POINT_PIPELINE 1
+
+/*
+    Banded rendering. 1 for yes, 0 for no.
+
+    Without banding, the whole frame array must fit on the stack, which limits the frame to about 36x36.
+    With banding, the frame is split into horizontal bands of BAND_NUM_ROWS rows. Only one band is held
+    in the frame array at a time - each is rasterised and then written to its own window of the display
+    before the next band is rasterised. Triangles are binned per frame (see TriangleBin in mesh.h) such
+    that each band only draws the triangles that cover it. FRAME_NUM_ROWS and FRAME_NUM_COLS may then be as
+    large as the screen, SCREEN_MAX_ROWS and SCREEN_MAX_COLS, for the cost of a BAND_NUM_ROWS row array.
+
+    FRAME_NUM_ROWS must be a multiple of BAND_NUM_ROWS.
+    Only the mesh demos (square and cube) support banded rendering. The banded tests in test/ check that they
+    send the same frames as without banding.
+*/
+#define BANDED_RENDERING 0
+#define BAND_NUM_ROWS 8
+
+/*
+    Scanline rendering. 1 for yes, 0 for no.
+
+    An alternative to the frame array altogether. The culled and shaded triangles of a frame are stored in an
+    edge table sorted by their top row. The frame is then generated one row at a time from the top, with an active
+    list holding the edges of only those triangles crossing the current row. Each row is built straight into the
+    16 bit colour format of the display and sent before the next is generated (see scanline.h). Memory then scales
+    with the number of triangles rather than the number of pixels, so the frame may be as large as the screen.
+
+    SCANLINE_MAX_ACTIVE is the most triangles that can cross one row. Any more are not drawn, and the mesh demos
+    print how many were dropped.
+    Only the mesh demos (square and cube) support scanline rendering and it cannot be combined with banded rendering.
+*/
+#define SCANLINE_RENDERING 0
+#define SCANLINE_MAX_ACTIVE 8
+
+/*
+    Number of frame rows sent to the display per SPI transfer by writeFrame().
+    The rows are converted into a staging buffer of (2 * FRAME_NUM_COLS) bytes per row, held in .bss,
+    and then sent in one transfer. Larger values spend more SRAM for fewer transfers, and so less driver overhead.
+    With RENDER_SCALE above 1, these are rows of the screen, (2 * FRAME_SCREEN_COLS) bytes each, and each frame row
+    is sent as RENDER_SCALE of them. The scanout tests in test/ count the transfers and bytes sent per frame.
+*/
+#define SCANOUT_ROWS_PER_TRANSFER 1
+
+/*
+    Asynchronous scanout. 1 for yes, 0 for no.
+
+    writeFrame() stages rows into two buffers in turn (ping-pong). Each buffer is sent by the SPI interrupt while the
+    CPU converts the next rows into the other buffer. writeFrame() returns as soon as the last buffer has been started,
+    so rasterisation of the next frame (or band) overlaps with its transfer. This doubles the staging buffer SRAM.
+    With banded rendering, SCANOUT_ROWS_PER_TRANSFER = BAND_NUM_ROWS overlaps the whole of each band's transfer
+    with the rasterisation of the next band. The async_scanout tests in test/ run it against a simulated interrupt.
+*/
+#define ASYNC_SCANOUT 0
+
+/*
+    Dirty rectangles. 1 for yes, 0 for no.
+
+    drawTriangle() records the bounding box of everything drawn to the frame since it was last reset. writeFrame() then
+    reprograms the write area of the display to the window covering both this box and that of the previous frame, whose
+    pixels must be erased, and only sends that window. For a small object this is a fraction of the frame.
+    Not supported with banded or scanline rendering. The dirty_rectangles tests in test/ replay the windows into a
+    simulated GDRAM and check it against that of whole frames.
+*/
+#define DIRTY_RECTANGLES 0
+
+/*
+    Row signatures. 1 for yes, 0 for no.
+
+    writeFrame() keeps a one byte CRC-8 signature of each row it last sent, FRAME_NUM_ROWS bytes in all.
+    Rows whose signature has not changed are skipped by moving the write area of the display past them. This benefits
+    any rendering code without changes. A changed row has a 1 in 256 chance of sharing the old signature, a collision,
+    in which case the display is left showing the old row. So that a stale row is not left until it changes again,
+    which for a still part of the picture may be never, one row per frame is sent regardless in turn, refreshing
+    every row within FRAME_NUM_ROWS frames. The average rows sent and skipped per frame are printed by the demos.
+*/
+#define ROW_SIGNATURES 0
+
+/*
+    Hardware primitives. 1 for yes, 0 for no.
+
+    Lines, filled rectangles and clears are drawn by the SSD1331 itself from 5 to 11 byte commands (DRAWLINE,
+    DRAWRECT with FILL enabled and CLEAR) rather than by sending pixels. The frame array is not sent at all. Between
+    frames, the frame window of the display is cleared by one CLEAR command in place of RESET_FRAME and a scanout
+    of black pixels. The display needs time to draw each primitive, see kSSD1331DelaysHWFILL and kSSD1331DelaysHWLINE.
+
+    The SSD1331 cannot fill triangles, so WIREFRAME must be 1, drawTriangle() then drawing each edge as a DRAWLINE.
+    Not supported with banded or scanline rendering.
+*/
+#define HW_PRIMITIVES 0
+
+/*
+    Run-length scanout. 1 for yes, 0 for no.
+
+    writeFrame() looks for runs of at least RLE_MIN_RUN identical pixels in each row. Each run is drawn by the SSD1331
+    from one command, CLEAR (5 bytes) if black and DRAWRECT with FILL enabled (11 bytes) otherwise, in place of two
+    bytes per pixel. The rest of the row is sent as usual through a write area around each part. Rows without a run
+    are sent as usual. Runs are found a frame byte (two pixels) at a time.
+
+    RLE_MIN_RUN is the break-even length in frame pixels, which depends on the SPI clock and the driver overhead per transfer. It is
+    measured at start up by printRleBreakEven(), which the demos call. The rle_scanout tests in test/ check the pixels
+    drawn by the SSD1331 against those sent.
+
+    RLE_FILL_DELAY_MILLISECONDS is waited after each run. kSSD1331DelaysHWFILL is enough for a fill of the whole
+    screen, but a run is at most one row, which the SSD1331 fills in less time than the next command takes to send.
+*/
+#define RLE_SCANOUT 0
+#define RLE_MIN_RUN 16
+#define RLE_FILL_DELAY_MILLISECONDS 0
+
+/*
+    Register level SPI. 1 for yes, 0 for no.
+
+    The blocking transfers to the display write the SPI0 data register directly, polling the SPTEF and SPRF flags,
+    rather than going through SPI_DRV_MasterTransferBlocking() and its state and timeout bookkeeping for each call.
+    The bus is left as configured by the Warp firmware. Asynchronous scanout still uses the KSDK driver.
+    pushBytes() and pushPixelRun() are available to renderers, and the demos print a benchmark of both paths.
+    The register_level_spi tests in test/ run it against a model of the SPI0 registers.
+*/
+#define REGISTER_LEVEL_SPI 0
+
+/*
+    Interlaced rendering. 1 for yes, 0 for no.
+
+    Each frame renders and sends only one field, the even or the odd (C style) rows of the frame, as selected by
+    frame_field. The demos alternate the two, so each row of the display is updated every other frame, for about half
+    the rasterisation and SPI traffic per frame. drawPixel() and drawHorizontalLine() skip rows outside of the field
+    and writeFrame() moves the write area of the display past them. frame_field may also be FIELD_ALL_ROWS, which
+    the triangles demo uses to compare progressive and interlaced frames.
+
+    Not supported with scanline rendering or hardware primitives.
+*/
+#define INTERLACED 0
+
+/*
+    Direct rendering. 1 for yes, 0 for no.
+
+    drawTriangle() sends each horizontal span straight to the display rather than filling the frame array, which is
+    then not allocated at all. Each span is sent as its pixels through a write area of its own row or, with
+    DIRECT_HW_SPANS, as a DRAWRECT command (11 bytes) that the SSD1331 fills itself. As with run-length scanout, no
+    delay is waited after each. The frame window is cleared by one CLEAR command at the start of each frame, in place
+    of RESET_FRAME and scanout. Triangles are drawn on the display as they are rasterised, so frames may flicker.
+
+    The SPI time then grows with the spans and pixels drawn rather than the size of the frame, which suits sparse
+    scenes. printDirectBreakEven() measures the time per span, per pixel and per frame buffer scanout at start up, and
+    printDirectRenderingCounts() estimates the number of triangles and pixels at which the frame buffer becomes
+    cheaper. The demos call both.
+
+    Not supported with banded or scanline rendering, hardware primitives, dirty rectangles, row signatures, run-length
+    scanout or interlacing, which all concern the frame array.
+*/
+#define DIRECT_RENDERING 0
+#define DIRECT_HW_SPANS 0
+
+/*
+    Display backend, one of the DISPLAY_ constants below. The renderer draws through the display functions of display.h.
+
+    DISPLAY_SSD1331 is the 96x64 colour OLED of devSSD1331.c. DISPLAY_SSD1306 is a 128x64 monochrome OLED, on the same
+    SPI pins, of devSSD1306.c. It keeps one bit per pixel of the frame, with the relative intensity ordered dithered.
+    DISPLAY_HOST builds the renderer for a PC with display_host.c, which writes each frame as a PPM image and counts the
+    bytes that an SSD1331 would have been sent, so the pipeline can be benchmarked and checked without a display.
+
+    With DISPLAY_VTABLE 0, the display functions are the backend's own, bound at compile time. With DISPLAY_VTABLE 1,
+    they call through the DisplayBackend pointed to by display, which may then be changed at run time to any backend
+    built for the same target.
+
+    The rendering and scanout options above that call on devSSD1331.c directly are only supported by the SSD1331,
+    bound at compile time.
+*/
+#define DISPLAY_SSD1331 0
+#define DISPLAY_SSD1306 1
+#define DISPLAY_HOST 2
+
+#define DISPLAY_BACKEND DISPLAY_SSD1331
+#define DISPLAY_VTABLE 0
+
 /*
     Used to set the refresh rate of the display. See the 'FR Synchronisation' section of the SSD1331 manual.
     Should be between b0000 and b1111 which results in a divisor equal to the decimal value plus 1.
@@ -90,9 +413,113 @@
 /*
     Used to easily defined the correct sized array.
 */
-#define FRAME_TRUE_ROWS FRAME_NUM_ROWS
+#if (BANDED_RENDERING)
+    #define FRAME_TRUE_ROWS BAND_NUM_ROWS
+    #define NUM_BANDS (FRAME_NUM_ROWS / BAND_NUM_ROWS)
+#else
+    #define FRAME_TRUE_ROWS FRAME_NUM_ROWS
+    #define NUM_BANDS 1
+#endif
 #define FRAME_TRUE_COLS (FRAME_NUM_COLS / PIXELS_PER_BYTE)
 
+/* Size of the frame on the screen. */
+#define FRAME_SCREEN_ROWS (RENDER_SCALE * FRAME_NUM_ROWS)
+#define FRAME_SCREEN_COLS (RENDER_SCALE * FRAME_NUM_COLS)
+
+#if (RENDER_SCALE < 1) || (RENDER_SCALE > 3)
+    #error "RENDER_SCALE must be 1, 2 or 3."
+#endif
+
+#if (FRAME_SCREEN_ROWS > SCREEN_MAX_ROWS) || (FRAME_SCREEN_COLS > SCREEN_MAX_COLS)
+    #error "The frame, scaled by RENDER_SCALE, must fit on the screen."
+#endif
+
+#if (OUTER_FRAME) && ((FRAME_SCREEN_ROWS + 2 > SCREEN_MAX_ROWS) || (FRAME_SCREEN_COLS + 2 > SCREEN_MAX_COLS))
+    #error "The outer frame must fit around the frame on the screen."
+#endif
+
+#if (RENDER_SCALE > 1) && ((SCANLINE_RENDERING) || (HW_PRIMITIVES))
+    #error "Render scales above 1 are applied by writeFrame() and are not supported with scanline rendering or hardware primitives."
+#endif
+
+#if (BANDED_RENDERING) && (FRAME_NUM_ROWS % BAND_NUM_ROWS)
+    #error "FRAME_NUM_ROWS must be a multiple of BAND_NUM_ROWS."
+#endif
+
+#if (BANDED_RENDERING) && (TRIANGLES_VS_FRAMERATE_DEMO)
+    #error "Banded rendering is only supported by the mesh demos."
+#endif
+
+#if (SCANLINE_RENDERING) && ((TRIANGLES_VS_FRAMERATE_DEMO) || (BANDED_RENDERING))
+    #error "Scanline rendering is only supported by the mesh demos, without banded rendering."
+#endif
+
+#if (DIRTY_RECTANGLES) && ((BANDED_RENDERING) || (SCANLINE_RENDERING))
+    #error "Dirty rectangles are not supported with banded or scanline rendering."
+#endif
+
+#if (HW_PRIMITIVES) && (!(WIREFRAME) || (BANDED_RENDERING) || (SCANLINE_RENDERING))
+    #error "Hardware primitives require wireframe triangles and are not supported with banded or scanline rendering."
+#endif
+
+#if (INTERLACED) && ((SCANLINE_RENDERING) || (HW_PRIMITIVES))
+    #error "Interlaced rendering is applied by writeFrame() and is not supported with scanline rendering or hardware primitives."
+#endif
+
+#if (DIRECT_RENDERING) && ((BANDED_RENDERING) || (SCANLINE_RENDERING) || (HW_PRIMITIVES) || (DIRTY_RECTANGLES) || \
+        (ROW_SIGNATURES) || (RLE_SCANOUT) || (INTERLACED))
+    #error "Direct rendering does not use the frame array and is not supported with the options that concern it."
+#endif
+
+/* Whether a display backend is built: that of DISPLAY_BACKEND and, with DISPLAY_VTABLE, the others for the same target. */
+#define DISPLAY_BUILT(backend) \
+    ( ((backend) == DISPLAY_BACKEND) || ((DISPLAY_VTABLE) && ((backend) != DISPLAY_HOST) && (DISPLAY_BACKEND != DISPLAY_HOST)) )
+
+#if ((DISPLAY_BACKEND != DISPLAY_SSD1331) || (DISPLAY_VTABLE)) && ((BANDED_RENDERING) || (SCANLINE_RENDERING) || \
+        (HW_PRIMITIVES) || (ROW_SIGNATURES) || (RLE_SCANOUT) || (REGISTER_LEVEL_SPI) || (INTERLACED) || (DIRECT_RENDERING))
+    #error "These rendering and scanout options are only supported by the SSD1331 display backend, bound at compile time."
+#endif
+
+#if ((ROW_SIGNATURES) || (RLE_SCANOUT)) && (SCANLINE_RENDERING)
+    #error "Row signatures and run-length scanout are only applied by writeFrame(), which scanline rendering does not use."
+#endif
+
+#if ((HALF_SPACE_RASTERISER) || (RASTERISER_BENCHMARK)) && ((WIREFRAME) || (SCANLINE_RENDERING) || (DIRECT_RENDERING))
+    #error "The half-space rasteriser fills triangles into the frame array and is not supported with wireframe, scanline or direct rendering."
+#endif
+
+#if (RASTERISER_BENCHMARK) && (BANDED_RENDERING)
+    #error "The rasteriser benchmark draws over the whole frame array and is not supported with banded rendering."
+#endif
+
+#if (SUBPIXEL_BITS < 0) || (SUBPIXEL_BITS > 4)
+    #error "SUBPIXEL_BITS must be 0 to 4."
+#endif
+
+#if (SUBPIXEL_BITS) && (!(HALF_SPACE_RASTERISER) || (RASTERISER_BENCHMARK))
+    #error "Sub-pixel vertices are only supported by the half-space rasteriser, without the rasteriser benchmark."
+#endif
+
+#if (SCREEN_CLIPPING) && ((FRAME_NUM_COLS << SUBPIXEL_BITS) > GUARD_BAND_LIMIT)
+    #error "The frame must lie within the guard band."
+#endif
+
+#if (SCREEN_CLIPPING) && (RASTERISER_BENCHMARK)
+    #error "Screen-space clipping is not supported with the rasteriser benchmark."
+#endif
+
+#if (SCREEN_SPACE_CULLING) && !(SCREEN_CLIPPING)
+    #error "Screen-space culling needs the unclamped vertices of screen-space clipping."
+#endif
+
+#if (DEPTH_CLIPPING) && (TRIANGLES_VS_FRAMERATE_DEMO)
+    #error "Near and far plane clipping are only supported by the mesh demos."
+#endif
+
+#if (HALF_SPACE_BLOCK_COLS < 2) || (HALF_SPACE_BLOCK_COLS % 2) || (HALF_SPACE_BLOCK_ROWS < 1)
+    #error "HALF_SPACE_BLOCK_COLS must be a positive even number, whole bytes of the frame, and HALF_SPACE_BLOCK_ROWS positive."
+#endif
+
 /*
     b11110.
     
@@ -156,9 +583,9 @@
 
 
 /*
-    The amount by which to translate any vertices into the Z axis
+    The amount by which the demos translate the scene into the Z axis
     such that vertices are not rendered around (0, 0, 0).
-    See documentation for z_translate in projection.c for much more infomation.
+    See documentation for model_view_translate in projection.h for much more infomation.
 */
 #define Z_TRANSLATION 2.5
 
@@ -185,6 +612,38 @@
     dest[X] = src[X]; \
     dest[Y] = src[Y];
 
+/*
+    Converts the y coordinate of a pixel into the row of the frame array that holds it.
+
+    With banded rendering, the frame array only holds the rows of the current band, which starts at
+    band_first_row. Rows of other bands (and y coordinates outside of the frame) convert to a row
+    of BAND_NUM_ROWS or more as the result is unsigned, so they are easily skipped.
+*/
+#if (BANDED_RENDERING)
+    #define FRAME_ROW(y) ( (uint8_t) (FRAME_NUM_ROWS - (y) - 1 - band_first_row) )
+#else
+    #define FRAME_ROW(y) ( FRAME_NUM_ROWS - (y) - 1 )
+#endif
+
+/*
+    Whether a (C style) row of the whole frame lies in the field being rendered.
+    With banded rendering, this is not the row of the frame array but that plus band_first_row.
+*/
+#if (INTERLACED)
+    #define ROW_IN_FIELD(row) ( (frame_field == FIELD_ALL_ROWS) || (((row) % 2) == frame_field) )
+#endif
+
+/* Empties a DirtyRect. A rect is empty if first_row > last_row. */
+#if (DIRTY_RECTANGLES)
+    #define RESET_DIRTY_RECT(rect) \
+        (rect).first_row = FRAME_NUM_ROWS; \
+        (rect).last_row = 0; \
+        (rect).first_col = FRAME_NUM_COLS; \
+        (rect).last_col = 0;
+#else
+    #define RESET_DIRTY_RECT(rect)
+#endif
+
 /* MEMSET not used as to avoid introduction of string.h. */
 #define RESET_FRAME(frame) \
     for (uint8_t i = 0; i < FRAME_TRUE_ROWS; i++) { \
@@ -192,6 +651,40 @@
             frame[i][j] = 0; \
         } \
     } \
+    RESET_DIRTY_RECT(frame_dirty_rect) \
+
+/*
+    The scalar types of the geometry pipeline, selected by FIXED_POINT_PIPELINE.
+
+    Scalar holds coordinates and normals. ScalarCoeff holds matrix coefficients, being sines and cosines
+    and products thereof. The macros below are used for all arithmetic on these types such that the same
+    source serves both pipelines. SCALAR() and SCALAR_COEFF() are for constants only.
+*/
+#if (FIXED_POINT_PIPELINE)
+    typedef FixedQ16 Scalar;
+    typedef FixedQ8 ScalarCoeff;
+
+    #define SCALAR(f) FIXED_Q16_FROM_FLOAT(f)
+    #define SCALAR_COEFF(f) FIXED_Q8_FROM_FLOAT(f)
+    #define SCALAR_MUL(a, b) fixed_mul_q16(a, b)
+    #define SCALAR_COEFF_MUL(a, b) fixed_mul_q8(a, b)
+    #define SCALAR_COEFF_MUL_SCALAR(coeff, s) fixed_mul_q8_q16(coeff, s)
+    #define SCALAR_MUL_DIV(a, b, c) fixed_mul_div_q16(a, b, c)
+    #define DOT_PRODUCT_3D(vec1, vec2) dot_product_fixed_3d(vec1, vec2)
+    #define CROSS_PRODUCT_3D(vec1, vec2, result) cross_product_fixed_3d(vec1, vec2, result)
+#else
+    typedef float Scalar;
+    typedef float ScalarCoeff;
+
+    #define SCALAR(f) ( (float) (f) )
+    #define SCALAR_COEFF(f) ( (float) (f) )
+    #define SCALAR_MUL(a, b) ( (a) * (b) )
+    #define SCALAR_COEFF_MUL(a, b) ( (a) * (b) )
+    #define SCALAR_COEFF_MUL_SCALAR(coeff, s) ( (coeff) * (s) )
+    #define SCALAR_MUL_DIV(a, b, c) ( ((a) * (b)) / (c) )
+    #define DOT_PRODUCT_3D(vec1, vec2) dot_product_float_3d(vec1, vec2)
+    #define CROSS_PRODUCT_3D(vec1, vec2, result) cross_product_float_3d(vec1, vec2, result)
+#endif
 
 typedef enum {
     X = 0,
@@ -225,27 +718,124 @@ typedef struct {
     uint8_t colour;
 
     /* Three three-dimensional vertices. */
-    float vs[3][3];
+    Scalar vs[3][3];
 
     /* Normal vector to the triangle surface. Defined by the right-hand rule. */
-    float normal[3];
+    Scalar normal[3];
 } Triangle3D;
 
+/* A 3x3 matrix of coefficients, m[row][column]. */
+typedef struct {
+    ScalarCoeff m[3][3];
+} Mat3;
+
 /*
-    A type to store the scene to be rendered. Used as the triangles' normals do
-    not need to be stored. It is simply the above but with the normal attribute
-    removed.
+    The model-view transform. A vertex v is transformed to (m * v) + translation.
+    It is built once per frame from rotations, scales and translations (see projection.h)
+    and then applied to every vertex drawn in that frame.
 */
 typedef struct {
-    uint8_t colour;
-    float vs[3][3];
-} Triangle3DStorage;
+    Mat3 m;
+    Scalar translation[3];
+} ModelView;
+
+#if (BANDED_RENDERING)
+    /* First row of the frame (C style, counted from the top) held in the frame array. Set before rasterising each band. */
+    extern uint8_t band_first_row;
+#endif
+
+#if (INTERLACED)
+    /* The rows of the frame rendered and sent. */
+    typedef enum {
+        FIELD_EVEN_ROWS = 0,    /* C style rows 0, 2, 4, ... */
+        FIELD_ODD_ROWS = 1,     /* C style rows 1, 3, 5, ... */
+        FIELD_ALL_ROWS = 2      /* Progressive. */
+    } Fields;
+
+    /* Field of the frame being rendered, one of Fields. Set before rasterising each frame. */
+    extern uint8_t frame_field;
+#endif
+
+#if (DIRTY_RECTANGLES)
+    /* A rectangle of the frame in C style rows and columns, inclusive. */
+    typedef struct {
+        uint8_t first_row;
+        uint8_t last_row;
+        uint8_t first_col;
+        uint8_t last_col;
+    } DirtyRect;
+
+    /* Bounding box of everything drawn by drawTriangle() since the frame was last reset with RESET_FRAME. */
+    extern DirtyRect frame_dirty_rect;
+#endif
+
+/*
+    The functions of a display backend, see display.h. Columns and rows are those of the frame, C style with row 0 at
+    the top, and inclusive. The backend scales the frame by RENDER_SCALE and places it on its screen.
+*/
+typedef struct {
+    /* Resets and initialises the display, and clears it. */
+    void (*init)(void);
+
+    /* Sets the window written by push_pixels(), from its top row. */
+    void (*set_window)(uint8_t first_col, uint8_t first_row, uint8_t last_col, uint8_t last_row);
+
+    /*
+        Writes the next row of the window. Its num_pixels pixel values are packed two to a byte as in a frame row,
+        the first in the lower nibble of pixels[0].
+    */
+    void (*push_pixels)(const uint8_t *pixels, uint8_t num_pixels);
+
+    /* Fills a rectangle with one pixel value, with a command of the display where it has one. */
+    void (*hw_fill)(uint8_t first_col, uint8_t first_row, uint8_t last_col, uint8_t last_row, uint8_t pixel_value);
+
+    /*
+        Completes a frame. frame is sent to the display, which may still be in progress on return. NULL may be
+        passed for a frame drawn with the functions above, and waits until everything has been sent.
+    */
+    void (*flush)(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS]);
+} DisplayBackend;
+
+/*
+    A coordinate of a projected vertex, in pixels with SUBPIXEL_BITS fractional bits. Pixel centres lie at whole
+    numbers of pixels. VERTEX_PIXEL() truncates it to a whole pixel, so the pixels of the vertices of a triangle
+    bound the pixel centres that it covers and lie in the frame.
+
+    With GUARD_BAND_RASTERISING, vertices may lie off the frame within the guard band, see SCREEN_CLIPPING. The
+    coordinate is then signed and VERTEX_PIXEL() floors it, so may lie off the frame.
+*/
+#define GUARD_BAND_RASTERISING ( (SCREEN_CLIPPING) && (HALF_SPACE_RASTERISER) )
+
+#if (GUARD_BAND_RASTERISING)
+    typedef int16_t VertexCoord;
+
+    #define VERTEX_PIXEL(coord) ( (int16_t) ((coord) >> SUBPIXEL_BITS) )
+#elif (SUBPIXEL_BITS)
+    typedef uint16_t VertexCoord;
+
+    #define VERTEX_PIXEL(coord) ( (uint8_t) ((coord) >> SUBPIXEL_BITS) )
+#else
+    typedef uint8_t VertexCoord;
+
+    #define VERTEX_PIXEL(coord) (coord)
+#endif
+
+/*
+    A coordinate of a projected vertex before clipping, as VertexCoord but signed and within GUARD_BAND_LIMIT of
+    the centre of the frame. Without screen-space clipping, vertices are clamped into the frame as they are
+    projected, so it is VertexCoord itself.
+*/
+#if (SCREEN_CLIPPING)
+    typedef int16_t ScreenCoord;
+#else
+    typedef VertexCoord ScreenCoord;
+#endif
 
 /* The 2D version of the 3D triangle defined above. Has some extra attributes concerned with displaying. */
 typedef struct {
     uint8_t colour;
     uint8_t relative_intensity; /* Must be 0, 1, 2, or 3. Must fit in 2 bits. */
-    uint8_t vs[3][2];           /* Three two-dimensional vertices. */
+    VertexCoord vs[3][2];       /* Three two-dimensional vertices. */
 } Triangle2D;
 
 /*
@@ -271,7 +861,7 @@ void drawPixel(
     uint8_t relative_intensity
 );
 
-/* Gets the 4 bit pixel value by referencing the frame buffer in the x-y basis. */
+/* Gets the 4 bit pixel value by referencing the frame buffer in the x-y basis. With banded rendering, y must lie in the current band. */
 uint8_t get_pixel_value_xy(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], uint8_t x, uint8_t y);
 
 /* Gets the 4 bit pixel value by referencing the frame buffer in the row-column basis. */
@@ -281,4 +871,10 @@ uint8_t get_pixel_value_rowcol(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS],
 float dot_product_float_3d(float vec1[3], float vec2[3]);
 
 /* Calculates simple cross product between two floating point vectors, stores answer in result. */
-void cross_product_float_3d(float vec1[3], float vec2[3], float result[3]);
\ No newline at end of file
+void cross_product_float_3d(float vec1[3], float vec2[3], float result[3]);
+
+/* Multiplies the vector vec by the matrix mat, stores answer in result. result must not alias vec. */
+void mat3_mul_vec3(const Mat3 *mat, const Scalar vec[3], Scalar result[3]);
+
+/* Multiplies the matrix mat1 by the matrix mat2 (mat1 * mat2), stores answer in result. result must not alias either. */
+void mat3_mul_mat3(const Mat3 *mat1, const Mat3 *mat2, Mat3 *result);
\ No newline at end of file
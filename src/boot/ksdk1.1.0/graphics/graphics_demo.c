@@ -1,9 +1,12 @@
 #include <stdint.h>
+#include <stddef.h>
 
-#include "devSSD1331.h"
+#include "display.h"
 #include "draw_triangle.h"
 #include "draw_line.h"
 #include "projection.h"
+#include "clip.h"
+#include "mesh.h"
 #include "warp.h"
 
 #ifndef GRAPHICS
@@ -11,27 +14,46 @@
 	#define GRAPHICS
 #endif
 
+#if (TRIANGLES_VS_FRAMERATE_DEMO) && (INTERLACED)
+	/* Each step is rendered progressively and then interlaced, FRAMES_PER_STEP frames each. */
+	#define FRAMES_PER_STEP_RENDERED (2 * FRAMES_PER_STEP)
+#else
+	#define FRAMES_PER_STEP_RENDERED FRAMES_PER_STEP
+#endif
+
 #if (SPINNING_SQUARE_DEMO)
 
-	const Triangle3DStorage square[NUM_TRIANGLES] = 
+	/* Square constructed from two right hand rule triangles sharing an edge. */
+	const int8_t square_vertices[NUM_VERTICES][3] =
+	{
+		{-127, -127, -127},
+		{127, -127, -127},
+		{-127, 127, -127},
+		{127, 127, -127}
+	};
+
+	const uint16_t square_indices[NUM_TRIANGLES][3] =
 	{
 		/* Front face. */
-		{
-			B,					/* Colour. */
-			{					/* Vertices in -1.0 -> 1.0 space. */
-				{-L, -L, -L},
-				{L, -L, -L},
-				{-L, L, -L}
-			}
-		},
-		{
-			B,					/* Colour. */
-			{					/* Vertices in -1.0 -> 1.0 space. */
-				{-L, L, -L},
-				{L, -L, -L},
-				{L, L, -L}
-			}
-		}
+		{0, 1, 2},
+		{2, 1, 3}
+	};
+
+	const uint8_t square_colours[NUM_TRIANGLES] =
+	{
+		B, B
+	};
+
+	const Mesh square =
+	{
+		NUM_VERTICES,
+		NUM_TRIANGLES,
+		MESH_VERTEX_INT8,
+		0,					/* Not delta coded. */
+		SCALAR(L / 127.0),	/* -127 -> 127 maps to -L -> L. */
+		square_vertices,
+		square_indices,
+		square_colours
 	};
 #endif
 
@@ -40,299 +62,357 @@
 	/*
 		Cube constructed in terms of right hand rule triangles.
 		Stored in FLASH/ROM as of course this is memory intenstive.
-		We can read and rotate the vertices one by one each time, rather than store all 
-		the rotated versions for every frame.
+		The 8 corners are stored once and each triangle indexes three of them. Each corner is
+		transformed once per frame into a VertexCache rather than once per triangle that uses it.
+		The corners are quantised to int8_t, 3 bytes each rather than the 12 of three Scalars.
+
+		Vertex i has its x, y and z components at +L if bits 0, 1 and 2 of i are set respectively.
 	*/
-	const Triangle3DStorage cube[NUM_TRIANGLES] = 
+	const int8_t cube_vertices[NUM_VERTICES][3] =
+	{
+		{-127, -127, -127},
+		{127, -127, -127},
+		{-127, 127, -127},
+		{127, 127, -127},
+		{-127, -127, 127},
+		{127, -127, 127},
+		{-127, 127, 127},
+		{127, 127, 127}
+	};
+
+	const uint16_t cube_indices[NUM_TRIANGLES][3] =
 	{
 		/* Front face. */
-		{
-			B,					/* Colour. */
-			{					/* Vertices in -1.0 -> 1.0 space. */
-				{-L, -L, -L},
-				{L, -L, -L},
-				{-L, L, -L}
-			}
-		},
-		{
-			B,					/* Colour. */
-			{					/* Vertices in -1.0 -> 1.0 space. */
-				{-L, L, -L},
-				{L, -L, -L},
-				{L, L, -L}
-			}
-		},
+		{0, 1, 2},
+		{2, 1, 3},
+
 		/* Right-side face. */
-		{
-			G,					/* Colour. */
-			{					/* Vertices in -1.0 -> 1.0 space. */
-				{L, -L, -L},
-				{L, -L, L},
-				{L, L, -L}
-			}
-		},
-		{
-			G,					/* Colour. */
-			{					/* Vertices in -1.0 -> 1.0 space. */
-				{L, -L, L},
-				{L, L, L},
-				{L, L, -L}
-			}
-		},
+		{1, 5, 3},
+		{5, 7, 3},
 
 		/* Top face. */
-		{
-			R,					/* Colour. */
-			{					/* Vertices in -1.0 -> 1.0 space. */
-				{-L, L, L},
-				{-L, L, -L},
-				{L, L, -L}
-			}
-		},
-		{
-			R,					/* Colour. */
-			{					/* Vertices in -1.0 -> 1.0 space. */
-				{L, L, L},
-				{-L, L, L},
-				{L, L, -L}
-			}
-		},
+		{6, 2, 3},
+		{7, 6, 3},
 
 		/* Back face. */
-		{
-			B,					/* Colour. */
-			{					/* Vertices in -1.0 -> 1.0 space. */
-				{L, L, L},
-				{L, -L, L},
-				{-L, L, L}
-			}
-		},
-		{
-			B,					/* Colour. */
-			{					/* Vertices in -1.0 -> 1.0 space. */
-				{-L, L, L},
-				{L, -L, L},
-				{-L, -L, L}
-			}
-		},
+		{7, 5, 6},
+		{6, 5, 4},
 
 		/* Left face. */
-		{
-			G,					/* Colour. */
-			{					/* Vertices in -1.0 -> 1.0 space. */
-				{-L, L, -L},
-				{-L, L, L},
-				{-L, -L, L}
-			}
-		},
-		{
-			G,					/* Colour. */
-			{					/* Vertices in -1.0 -> 1.0 space. */
-				{-L, L, -L},
-				{-L, -L, L},
-				{-L, -L, -L}
-			}
-		},
-	
+		{2, 6, 4},
+		{2, 4, 0},
+
 		/* Bottom face. */
-		{
-			R,					/* Colour. */
-			{					/* Vertices in -1.0 -> 1.0 space. */
-				{-L, -L, L},
-				{L, -L, L},
-				{-L, -L, -L}
-			}
-		},
-		{
-			R,					/* Colour. */
-			{					/* Vertices in -1.0 -> 1.0 space. */
-				{-L, -L, -L},
-				{L, -L, L},
-				{L, -L, -L}
-			}
-		},
+		{4, 5, 0},
+		{0, 5, 1}
+	};
+
+	const uint8_t cube_colours[NUM_TRIANGLES] =
+	{
+		B, B,	/* Front face. */
+		G, G,	/* Right-side face. */
+		R, R,	/* Top face. */
+		B, B,	/* Back face. */
+		G, G,	/* Left face. */
+		R, R	/* Bottom face. */
+	};
+
+	const Mesh cube =
+	{
+		NUM_VERTICES,
+		NUM_TRIANGLES,
+		MESH_VERTEX_INT8,
+		0,					/* Not delta coded. */
+		SCALAR(L / 127.0),	/* -127 -> 127 maps to -L -> L. */
+		cube_vertices,
+		cube_indices,
+		cube_colours
 	};
 
 #endif
 
 void graphicsDemo(void)
 {
-	/* Initialise frame entirely to 0. */
-	uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS];
-	RESET_FRAME(frame);
+	#if (SCANLINE_RENDERING)
+		/* No frame array, the triangles of each frame are held in the edge table instead. */
+		ScanlineTable scanline_table;
+	#elif (DIRECT_RENDERING)
+		/* No frame array, the triangles are drawn straight to the display. Nothing is passed in its place. */
+		uint8_t (*frame)[FRAME_TRUE_COLS] = NULL;
+	#else
+		/* Initialise frame entirely to 0. */
+		uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS];
+		RESET_FRAME(frame);
+	#endif
+
+	/* Time to first frame is measured from the reset of the display. */
+	uint32_t init_milliseconds = OSA_TimeGetMsec();
+	uint32_t first_frame_milliseconds = 0;
 
 	/* Initialise screen. */
-	devSSD1331init();
+	displayInit();
 
-	#if (SPINNING_SQUARE_DEMO)
+	/* The benchmarks are run before the first frame, but are not part of the time to it. */
+	uint32_t benchmark_milliseconds = OSA_TimeGetMsec();
 
-		Triangle3D tri3;
-		Triangle2D tri2;
+	#if (REGISTER_LEVEL_SPI)
+		printSpiBenchmark();
+	#endif
 
-		uint32_t start_milliseconds = OSA_TimeGetMsec();
-		uint32_t end_milliseconds;
+	#if (RLE_SCANOUT)
+		printRleBreakEven();
+	#endif
 
-		for (uint8_t j = 0; j < NUM_ROTATIONS; j++) {
-			for (uint8_t rotation_num = 0; rotation_num < 255; rotation_num++) {
-				for (uint8_t tri_num = 0; tri_num < NUM_TRIANGLES; tri_num++) {
+	#if (DIRECT_RENDERING)
+		printDirectBreakEven();
+	#endif
 
-					tri3.colour = square[tri_num].colour;
+	#if (RASTERISER_BENCHMARK)
+		printRasteriserBenchmark(frame);
+	#endif
 
-					tri3.vs[0][X] = square[tri_num].vs[0][X];
-					tri3.vs[0][Y] = square[tri_num].vs[0][Y];
-					tri3.vs[0][Z] = square[tri_num].vs[0][Z];
+	init_milliseconds += OSA_TimeGetMsec() - benchmark_milliseconds;
 
-					tri3.vs[1][X] = square[tri_num].vs[1][X];
-					tri3.vs[1][Y] = square[tri_num].vs[1][Y];
-					tri3.vs[1][Z] = square[tri_num].vs[1][Z];
+	#if (SPINNING_SQUARE_DEMO) || (SPINNING_MULTICOLOUR_CUBE_DEMO)
 
-					tri3.vs[2][X] = square[tri_num].vs[2][X];
-					tri3.vs[2][Y] = square[tri_num].vs[2][Y];
-					tri3.vs[2][Z] = square[tri_num].vs[2][Z];
+		ModelView model_view;
+		VertexCache vertex_cache;
 
-					/*
-						With the triangle extracted, we now rotate it a certain amount for the purposes of the demo.
-						To do that, we need to define the two angles of rotation theta and phi, both analagous to their use in
-						spherical coordinates. That is, phi is the azimuthal angle.
+		#if (BANDED_RENDERING)
+			TriangleBin bins[NUM_TRIANGLES];
+		#endif
 
-						These angles are used to collect values from the uint8_t sine_lookup table.
-					*/
-					rotate(&tri3, rotation_num);
+		#if (SPINNING_SQUARE_DEMO)
+			const Mesh *mesh = &square;
+			uint8_t cull_mode = CULL_NONE; /* In this demo, we can see both sides of the square. */
+		#else
+			const Mesh *mesh = &cube;
+			uint8_t cull_mode = CULL_BACK;
+		#endif
 
-					z_translate(&tri3);
+		uint32_t start_milliseconds = OSA_TimeGetMsec();
+		uint32_t end_milliseconds;
 
-					find_triangle_normal(&tri3);
+		#if (INTERLACED)
+			frame_field = FIELD_EVEN_ROWS;
+		#endif
 
-					/* In this demo, we can see both sides of the square. */
-					project(tri3, &tri2);
-					drawTriangle(frame, tri2);
-				}
+		for (uint8_t j = 0; j < NUM_ROTATIONS; j++) {
+			for (uint8_t rotation_num = 0; rotation_num < 255; rotation_num++) {
 
-				writeFrame(frame);
+				/*
+					Build the frame's transform once, then apply it to every vertex.
+					To do that, we need to define the two angles of rotation theta and phi, both analagous to their use in
+					spherical coordinates. That is, phi is the azimuthal angle.
 
-				RESET_FRAME(frame);
-			}
-		}
+					These angles are used to collect values from the uint8_t sine_lookup table.
+					The object is then translated away from the camera.
+				*/
+				model_view_identity(&model_view);
+				model_view_rotate(&model_view, ROTATION_RATE_THETA * rotation_num, ROTATION_RATE_PHI * rotation_num);
+				model_view_translate(&model_view, SCALAR(0), SCALAR(0), SCALAR(Z_TRANSLATION));
 
-		end_milliseconds = OSA_TimeGetMsec();
+				/* Transform and project each unique vertex once, then assemble and draw the triangles from the cache. */
+				transform_mesh(mesh, &model_view, &vertex_cache);
 
-		/* Milliseconds division can be truncated safely. */
-		warpPrint("Average time per frame for %d frames: %dms.\n", NUM_ROTATIONS * 255, (end_milliseconds - start_milliseconds) / (NUM_ROTATIONS * 255));
+				#if (SCANLINE_RENDERING)
 
-	#elif (SPINNING_MULTICOLOUR_CUBE_DEMO)
+					/* Cull and shade into the edge table, then generate and write the frame row by row. */
+					scanline_reset(&scanline_table);
+					scanline_mesh(mesh, &vertex_cache, &scanline_table, cull_mode);
 
-		Triangle3D tri3;
-		Triangle2D tri2;
+					renderScanlines(&scanline_table);
 
-		uint32_t start_milliseconds = OSA_TimeGetMsec();
-		uint32_t end_milliseconds;
+					/* The rows have all been sent, which ends the frame. */
+					displayFlush(NULL);
 
-		for (uint8_t j = 0; j < NUM_ROTATIONS; j++) {
-			for (uint8_t rotation_num = 0; rotation_num < 255; rotation_num++) {
-				for (uint8_t tri_num = 0; tri_num < NUM_TRIANGLES; tri_num++) {
+				#elif (BANDED_RENDERING)
 
-					tri3.colour = cube[tri_num].colour;
+					/* Cull, shade and bin once, then rasterise and write each band in turn from the top of the frame. */
+					bin_mesh(mesh, &vertex_cache, bins, cull_mode);
 
-					tri3.vs[0][X] = cube[tri_num].vs[0][X];
-					tri3.vs[0][Y] = cube[tri_num].vs[0][Y];
-					tri3.vs[0][Z] = cube[tri_num].vs[0][Z];
+					for (uint8_t band = 0; band < NUM_BANDS; band++) {
+						band_first_row = band * BAND_NUM_ROWS;
 
-					tri3.vs[1][X] = cube[tri_num].vs[1][X];
-					tri3.vs[1][Y] = cube[tri_num].vs[1][Y];
-					tri3.vs[1][Z] = cube[tri_num].vs[1][Z];
+						drawMeshBand(frame, mesh, &vertex_cache, bins, band);
 
-					tri3.vs[2][X] = cube[tri_num].vs[2][X];
-					tri3.vs[2][Y] = cube[tri_num].vs[2][Y];
-					tri3.vs[2][Z] = cube[tri_num].vs[2][Z];
+						displayFlush(frame);
 
-					/*
-						With the triangle extracted, we now rotate it a certain amount for the purposes of the demo.
-						To do that, we need to define the two angles of rotation theta and phi, both analagous to their use in
-						spherical coordinates. That is, phi is the azimuthal angle.
+						RESET_FRAME(frame);
+					}
 
-						These angles are used to collect values from the uint8_t sine_lookup table.
-					*/
-					rotate(&tri3, rotation_num);
+				#elif (HW_PRIMITIVES) || (DIRECT_RENDERING)
 
-					z_translate(&tri3);
+					/* The edges or spans are drawn straight to the display, over a window cleared by one command. */
+					hwClearFrame();
 
-					find_triangle_normal(&tri3);
+					drawMesh(frame, mesh, &vertex_cache, cull_mode);
 
-					/*
-						If we can see the correct face of the triangle, project and draw it.
-						Can use any point on the triangle.
+					/* Everything has been drawn, which ends the frame. */
+					displayFlush(NULL);
 
-						This assumes that the camera lies at (0.0, 0.0, 0.0) and is directionless.
-					*/
-					if (dot_product_float_3d(tri3.normal, tri3.vs[0]) > 0.0) {
-						project(tri3, &tri2);
-						drawTriangle(frame, tri2);
-					}
-				}
+				#else
+
+					drawMesh(frame, mesh, &vertex_cache, cull_mode);
 
-				writeFrame(frame);
+					displayFlush(frame);
 
-				RESET_FRAME(frame);
+					RESET_FRAME(frame);
+
+				#endif
+
+				#if (INTERLACED)
+					/* The next frame renders and sends the other field. */
+					frame_field ^= 1;
+				#endif
+
+				if ( (j == 0) && (rotation_num == 0) ) {
+					displayFlush(NULL);
+					first_frame_milliseconds = OSA_TimeGetMsec() - init_milliseconds;
+				}
 			}
 		}
 
+		/* Include the sending of the last frame. */
+		displayFlush(NULL);
+
 		end_milliseconds = OSA_TimeGetMsec();
 
 		/* Milliseconds division can be truncated safely. */
 		warpPrint("Average time per frame for %d frames: %dms.\n", NUM_ROTATIONS * 255, (end_milliseconds - start_milliseconds) / (NUM_ROTATIONS * 255));
+		warpPrint("Time to first frame: %dms.\n", first_frame_milliseconds);
+
+		printCullingCounts(NUM_ROTATIONS * 255);
 
+		#if (SCANLINE_RENDERING)
+			printScanlineCounts(NUM_ROTATIONS * 255);
+		#endif
+
+		#if (ROW_SIGNATURES)
+			printScanoutRowCounts(NUM_ROTATIONS * 255);
+		#endif
+
+		#if (DIRECT_RENDERING)
+			printDirectRenderingCounts(NUM_ROTATIONS * 255);
+		#endif
+
+		#if (DISPLAY_BACKEND == DISPLAY_HOST)
+			printHostDisplayCounts(NUM_ROTATIONS * 255);
+		#endif
 
 	#elif (TRIANGLES_VS_FRAMERATE_DEMO)
 
 		Triangle3D tri3;
+		ScreenCoord projected[3][2];
 		Triangle2D tri2;
+		VertexCoord polygon[CLIP_MAX_VERTICES][2];
+		uint8_t num_vertices;
+		ModelView model_view;
 
 		uint32_t start_milliseconds = OSA_TimeGetMsec();
 		uint32_t end_milliseconds;
 
+		#if (INTERLACED)
+			uint32_t progressive_milliseconds;
+		#endif
+
 		for (uint16_t num_tris = START_TRIANGLES; num_tris <= END_TRIANGLES; num_tris += STEP_TRIANGLES) {
-			for (uint16_t frame_num = 0; frame_num < FRAMES_PER_STEP; frame_num++) {
-				
+			for (uint16_t frame_num = 0; frame_num < FRAMES_PER_STEP_RENDERED; frame_num++) {
+
+				#if (INTERLACED)
+					if (frame_num == FRAMES_PER_STEP) {
+						/* Include the sending of the last progressive frame. */
+						displayFlush(NULL);
+
+						end_milliseconds = OSA_TimeGetMsec();
+						progressive_milliseconds = end_milliseconds - start_milliseconds;
+						start_milliseconds = end_milliseconds;
+					}
+
+					/* Whole frames, then alternate fields. */
+					frame_field = (frame_num < FRAMES_PER_STEP) ? FIELD_ALL_ROWS : (frame_num % 2);
+				#endif
+
+				#if (HW_PRIMITIVES) || (DIRECT_RENDERING)
+					hwClearFrame();
+				#endif
+
+				/* As in the other demos, the frame's transform is built once per frame. */
+				model_view_identity(&model_view);
+				model_view_rotate(&model_view, ROTATION_RATE_THETA * frame_num, ROTATION_RATE_PHI * frame_num);
+				model_view_translate(&model_view, SCALAR(0), SCALAR(0), SCALAR(Z_TRANSLATION));
+
 				for (uint16_t tri_num = 0; tri_num < num_tris; tri_num++) {
 					/* Vary colour so something can be seen on screen. */
 					tri3.colour = (uint8_t) (frame_num % 3) + 1;
 
 					/* Re-populate tri3 each time to mimic more realistic rendering demo. */
-					tri3.vs[0][X] = -0.5;
-					tri3.vs[0][Y] = -0.5;
-					tri3.vs[0][Z] = -0.5;
+					tri3.vs[0][X] = SCALAR(-0.5);
+					tri3.vs[0][Y] = SCALAR(-0.5);
+					tri3.vs[0][Z] = SCALAR(-0.5);
 
-					tri3.vs[1][X] = 0.5;
-					tri3.vs[1][Y] = -0.5;
-					tri3.vs[1][Z] = -0.5;
+					tri3.vs[1][X] = SCALAR(0.5);
+					tri3.vs[1][Y] = SCALAR(-0.5);
+					tri3.vs[1][Z] = SCALAR(-0.5);
 
-					tri3.vs[2][X] = -0.5;
-					tri3.vs[2][Y] = 0.5;
-					tri3.vs[2][Z] = -0.5;
+					tri3.vs[2][X] = SCALAR(-0.5);
+					tri3.vs[2][Y] = SCALAR(0.5);
+					tri3.vs[2][Z] = SCALAR(-0.5);
 
 					/* The following function calls won't really do much but we need to take into account their processing. */
-					// rotate(&tri3, 0);
-					
-					z_translate(&tri3);
+					transform(&tri3, &model_view);
 
 					find_triangle_normal(&tri3);
 
-					project(tri3, &tri2);
-					drawTriangle(frame, tri2);
+					project(tri3, projected, &tri2);
+					num_vertices = clip_triangle(projected, polygon);
+					drawClippedPolygon(frame, polygon, num_vertices, &tri2);
 				}
 			
-				writeFrame(frame);
-				RESET_FRAME(frame);
+				#if (HW_PRIMITIVES) || (DIRECT_RENDERING)
+					/* Everything has been drawn, which ends the frame. */
+					displayFlush(NULL);
+				#else
+					displayFlush(frame);
+					RESET_FRAME(frame);
+				#endif
+
+				if ( (num_tris == START_TRIANGLES) && (frame_num == 0) ) {
+					displayFlush(NULL);
+					first_frame_milliseconds = OSA_TimeGetMsec() - init_milliseconds;
+				}
 			}
 
+		/* Include the sending of the last frame. */
+		displayFlush(NULL);
+
 		end_milliseconds = OSA_TimeGetMsec();
 
 		/* Milliseconds division can be truncated safely. */
-		warpPrint("Average time per frame for %d frames rendering %d triangles: %dms.\n", FRAMES_PER_STEP, num_tris, (end_milliseconds - start_milliseconds) / FRAMES_PER_STEP);
+		#if (INTERLACED)
+			warpPrint("Average time per frame for %d frames rendering %d triangles: progressive %dms, interlaced %dms.\n",
+				FRAMES_PER_STEP, num_tris, progressive_milliseconds / FRAMES_PER_STEP, (end_milliseconds - start_milliseconds) / FRAMES_PER_STEP);
+		#else
+			warpPrint("Average time per frame for %d frames rendering %d triangles: %dms.\n", FRAMES_PER_STEP, num_tris, (end_milliseconds - start_milliseconds) / FRAMES_PER_STEP);
+		#endif
+
+		#if (ROW_SIGNATURES)
+			printScanoutRowCounts(FRAMES_PER_STEP_RENDERED);
+		#endif
+
+		#if (DIRECT_RENDERING)
+			printDirectRenderingCounts(FRAMES_PER_STEP_RENDERED);
+		#endif
+
+		#if (DISPLAY_BACKEND == DISPLAY_HOST)
+			printHostDisplayCounts(FRAMES_PER_STEP_RENDERED);
+		#endif
 
 		start_milliseconds = end_milliseconds;
 	}
 
+	warpPrint("Time to first frame: %dms.\n", first_frame_milliseconds);
+
 	#endif
 
 }
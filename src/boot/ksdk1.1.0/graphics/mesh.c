@@ -0,0 +1,544 @@
+#include <stdint.h>
+
+#include "draw_triangle.h"
+#include "clip.h"
+#include "projection.h"
+#include "mesh.h"
+#include "warp.h"
+
+uint32_t trianglesCulled = 0;
+
+#if (SCREEN_SPACE_CULLING)
+    /*
+        Twice the signed area of the projected polygon of num_vertices vertices, the sum of those of its fan. Positive
+        if the vertices wind anticlockwise, y increasing up the frame, that is if its front faces the camera.
+
+        Within the guard band, each difference is below 2^14, so the sum of the at most three areas fits in 32 bits.
+    */
+    static int32_t projectedArea(const ScreenCoord projected[][2], uint8_t num_vertices)
+    {
+        int32_t area = 0;
+
+        for (uint8_t i = 0; i + 2 < num_vertices; i++) {
+            area += ((int32_t) (projected[i + 1][X] - projected[0][X]) * (projected[i + 2][Y] - projected[0][Y])) -
+                ((int32_t) (projected[i + 1][Y] - projected[0][Y]) * (projected[i + 2][X] - projected[0][X]));
+        }
+
+        return area;
+    }
+#endif
+
+/*
+    Culls tri3 by cull_mode and, if it is visible, finds its normal and shades tri2. projected are the
+    num_projected vertices that tri3 was projected to, in the same winding, which with SCREEN_SPACE_CULLING
+    decide which face is seen. Returns non zero if the triangle is visible.
+*/
+static uint8_t cullAndShadeTriangle(
+    Triangle3D *tri3,
+    const ScreenCoord projected[][2],
+    uint8_t num_projected,
+    Triangle2D *tri2,
+    uint8_t cull_mode
+)
+{
+    #if (SCREEN_SPACE_CULLING)
+
+        /* The sign of the projected area matches that of the dot product below, without the normal. */
+        int32_t facing = projectedArea(projected, num_projected);
+
+    #else
+
+        Scalar facing;
+
+        /* Only culled on in screen space. */
+        (void) projected;
+        (void) num_projected;
+
+        find_triangle_normal(tri3);
+
+        /*
+            If we can see the correct face of the triangle, shade it.
+            Can use any point on the triangle.
+
+            This assumes that the camera lies at (0.0, 0.0, 0.0) and is directionless.
+        */
+        facing = DOT_PRODUCT_3D(tri3->normal, tri3->vs[0]);
+
+    #endif
+
+    /* Triangles seen edge on are culled by either mode. */
+    if ( ((cull_mode == CULL_BACK) && !(facing > 0)) || ((cull_mode == CULL_FRONT) && !(facing < 0)) ) {
+        trianglesCulled++;
+        return 0;
+    }
+
+    #if (SCREEN_SPACE_CULLING)
+        /* Only the triangles that are drawn need their normals, to be shaded. */
+        find_triangle_normal(tri3);
+    #endif
+
+    shade(tri3, tri2);
+
+    return 1;
+}
+
+#if (DEPTH_CLIPPING)
+
+    /*
+        Finds the depth outcodes of the vertices of tri3. Returns non zero if the triangle lies wholly beyond the
+        near or far plane, in which case it is culled without being projected.
+    */
+    static uint8_t depthOutcodes(const Triangle3D *tri3, uint8_t codes[3])
+    {
+        for (uint8_t i = 0; i < 3; i++) {
+            codes[i] = depth_outcode(tri3->vs[i]);
+        }
+
+        return codes[0] & codes[1] & codes[2];
+    }
+
+    /*
+        Clips tri3, which crosses the near or far plane, to them and projects the vertices of the resulting
+        polygon into projected. Returns their number. The polygon is drawn as a fan from its first vertex.
+    */
+    static uint8_t clipAndProjectDepth(const Triangle3D *tri3, const uint8_t codes[3], ScreenCoord projected[DEPTH_CLIP_MAX_VERTICES][2])
+    {
+        Scalar clipped[DEPTH_CLIP_MAX_VERTICES][3];
+        uint8_t num_vertices;
+
+        num_vertices = clip_triangle_depth(tri3, codes, clipped);
+
+        for (uint8_t i = 0; i < num_vertices; i++) {
+            project_vertex(clipped[i], projected[i]);
+        }
+
+        return num_vertices;
+    }
+
+    /* Sets fan to triangle i, from 0, of the fan of the polygon projected by clipAndProjectDepth(). */
+    static void depthFanTriangle(const ScreenCoord projected[DEPTH_CLIP_MAX_VERTICES][2], uint8_t i, ScreenCoord fan[3][2])
+    {
+        COPY_2D_VERTEX(fan[0], projected[0]);
+        COPY_2D_VERTEX(fan[1], projected[i + 1]);
+        COPY_2D_VERTEX(fan[2], projected[i + 2]);
+    }
+
+    /*
+        Draws the polygon projected by clipAndProjectDepth() in the colour and relative intensity of tri2. Each
+        triangle of the fan is clipped to the frame as any other.
+    */
+    static void drawDepthClippedPolygon(
+        uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS],
+        const ScreenCoord projected[DEPTH_CLIP_MAX_VERTICES][2],
+        uint8_t num_projected,
+        Triangle2D *tri2
+    )
+    {
+        ScreenCoord fan[3][2];
+        VertexCoord polygon[CLIP_MAX_VERTICES][2];
+        uint8_t num_vertices;
+
+        for (uint8_t i = 0; i + 2 < num_projected; i++) {
+            depthFanTriangle(projected, i, fan);
+
+            num_vertices = clip_triangle(fan, polygon);
+            drawClippedPolygon(frame, polygon, num_vertices, tri2);
+        }
+    }
+
+#endif
+
+/*
+    Finishes drawing a triangle of a mesh once the camera space vertices of tri3, its pixel space
+    vertices and the colour of tri2 have been filled in. With DEPTH_CLIPPING, vertices beyond the
+    near or far plane need not have been projected.
+*/
+static void drawAssembledTriangle(
+    uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS],
+    Triangle3D *tri3,
+    const ScreenCoord projected[3][2],
+    Triangle2D *tri2,
+    uint8_t cull_mode
+)
+{
+    VertexCoord polygon[CLIP_MAX_VERTICES][2];
+    uint8_t num_vertices;
+
+    #if (DEPTH_CLIPPING)
+        ScreenCoord depth_projected[DEPTH_CLIP_MAX_VERTICES][2];
+        uint8_t num_projected;
+        uint8_t codes[3];
+
+        if (depthOutcodes(tri3, codes)) {
+            return;
+        }
+
+        /* The clipped polygon keeps the plane and winding of tri3, so is culled and shaded as tri3. */
+        if (codes[0] | codes[1] | codes[2]) {
+            num_projected = clipAndProjectDepth(tri3, codes, depth_projected);
+
+            if (cullAndShadeTriangle(tri3, depth_projected, num_projected, tri2, cull_mode)) {
+                drawDepthClippedPolygon(frame, depth_projected, num_projected, tri2);
+            }
+
+            return;
+        }
+    #endif
+
+    /*
+        Culled on the whole projected triangle before it is clipped, as above, so that a triangle is culled the
+        same by either mode wherever it lies, and faces turned away are never clipped.
+    */
+    if (!cullAndShadeTriangle(tri3, projected, 3, tri2, cull_mode)) {
+        return;
+    }
+
+    num_vertices = clip_triangle(projected, polygon);
+    drawClippedPolygon(frame, polygon, num_vertices, tri2);
+}
+
+/* Assembles triangle tri_num of the mesh from the cache filled by transform_mesh(). */
+static void assembleTriangle(
+    const Mesh *mesh,
+    const VertexCache *cache,
+    uint16_t tri_num,
+    Triangle3D *tri3,
+    ScreenCoord projected[3][2],
+    Triangle2D *tri2
+)
+{
+    const uint16_t *indices = mesh->indices[tri_num];
+
+    for (uint8_t i = 0; i < 3; i++) {
+        tri3->vs[i][X] = cache->vs[indices[i]][X];
+        tri3->vs[i][Y] = cache->vs[indices[i]][Y];
+        tri3->vs[i][Z] = cache->vs[indices[i]][Z];
+
+        COPY_2D_VERTEX(projected[i], cache->projected[indices[i]]);
+    }
+
+    tri2->colour = mesh->colours[tri_num];
+}
+
+void mesh_decode_vertex(const Mesh *mesh, uint16_t index, int16_t position[3], Scalar result[3])
+{
+    const Scalar *scalar_vertex;
+    const int8_t *int8_vertex;
+    const int16_t *int16_vertex;
+
+    if (mesh->vertex_format == MESH_VERTEX_SCALAR) {
+        scalar_vertex = ( (const Scalar (*)[3]) mesh->vertices )[index];
+
+        result[X] = scalar_vertex[X];
+        result[Y] = scalar_vertex[Y];
+        result[Z] = scalar_vertex[Z];
+        return;
+    }
+
+    for (uint8_t i = 0; i < 3; i++) {
+
+        /* Only the current vertex is read from flash, at 1 or 2 bytes per component. */
+        if (mesh->vertex_format == MESH_VERTEX_INT8) {
+            int8_vertex = ( (const int8_t (*)[3]) mesh->vertices )[index];
+
+            if (mesh->delta_coded) {
+                position[i] += int8_vertex[i];
+            } else {
+                position[i] = int8_vertex[i];
+            }
+
+        } else {
+            int16_vertex = ( (const int16_t (*)[3]) mesh->vertices )[index];
+
+            if (mesh->delta_coded) {
+                position[i] += int16_vertex[i];
+            } else {
+                position[i] = int16_vertex[i];
+            }
+        }
+
+        /*
+            A single integer multiply in the fixed point pipeline. The scale must be chosen such that
+            the quantised range maps to the -1.0 -> 1.0 space, for example L / 127 for int8_t.
+        */
+        result[i] = (Scalar) position[i] * mesh->scale;
+    }
+}
+
+void transform_mesh(const Mesh *mesh, const ModelView *mv, VertexCache *cache)
+{
+    Scalar v[3];
+    int16_t position[3] = {0, 0, 0}; /* Running position of delta coded meshes. */
+
+    for (uint16_t i = 0; i < mesh->num_vertices; i++) {
+        mesh_decode_vertex(mesh, i, position, v);
+
+        transform_vertex(mv, v, cache->vs[i]);
+
+        #if (DEPTH_CLIPPING)
+            /* Vertices beyond the near or far plane are only projected once clipped, if at all. */
+            if (depth_outcode(cache->vs[i])) {
+                continue;
+            }
+        #endif
+
+        project_vertex(cache->vs[i], cache->projected[i]);
+    }
+}
+
+void drawMesh(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], const Mesh *mesh, const VertexCache *cache, uint8_t cull_mode)
+{
+    Triangle3D tri3;
+    ScreenCoord projected[3][2];
+    Triangle2D tri2;
+
+    for (uint16_t tri_num = 0; tri_num < mesh->num_triangles; tri_num++) {
+        assembleTriangle(mesh, cache, tri_num, &tri3, projected, &tri2);
+
+        drawAssembledTriangle(frame, &tri3, projected, &tri2, cull_mode);
+    }
+}
+
+#if (BANDED_RENDERING)
+
+    void bin_mesh(const Mesh *mesh, const VertexCache *cache, TriangleBin *bins, uint8_t cull_mode)
+    {
+        Triangle3D tri3;
+        ScreenCoord projected[3][2];
+        Triangle2D tri2;
+        VertexCoord polygon[CLIP_MAX_VERTICES][2];
+        uint8_t num_vertices;
+        VertexCoord y_min;
+        VertexCoord y_max;
+
+        #if (DEPTH_CLIPPING)
+            ScreenCoord depth_projected[DEPTH_CLIP_MAX_VERTICES][2];
+            uint8_t num_projected;
+            uint8_t codes[3];
+        #endif
+
+        for (uint16_t tri_num = 0; tri_num < mesh->num_triangles; tri_num++) {
+            assembleTriangle(mesh, cache, tri_num, &tri3, projected, &tri2);
+
+            #if (DEPTH_CLIPPING)
+                if (depthOutcodes(&tri3, codes)) {
+                    bins[tri_num].relative_intensity = 0;
+                    continue;
+                }
+
+                /* Triangles crossing the near or far plane are projected again as they are drawn, so bin into every band. */
+                if (codes[0] | codes[1] | codes[2]) {
+                    num_projected = clipAndProjectDepth(&tri3, codes, depth_projected);
+
+                    bins[tri_num].relative_intensity = cullAndShadeTriangle(&tri3, depth_projected, num_projected, &tri2, cull_mode) ?
+                        tri2.relative_intensity : 0;
+                    bins[tri_num].first_band = 0;
+                    bins[tri_num].last_band = NUM_BANDS - 1;
+                    continue;
+                }
+            #endif
+
+            /* As in drawAssembledTriangle(), culled before it is clipped. */
+            if (!cullAndShadeTriangle(&tri3, projected, 3, &tri2, cull_mode)) {
+                bins[tri_num].relative_intensity = 0;
+                continue;
+            }
+
+            num_vertices = clip_triangle(projected, polygon);
+
+            if (!num_vertices) {
+                bins[tri_num].relative_intensity = 0;
+                continue;
+            }
+
+            bins[tri_num].relative_intensity = tri2.relative_intensity;
+
+            /* The bands covered by what is drawn of the triangle, so clipped. */
+            y_min = polygon[0][Y];
+            y_max = polygon[0][Y];
+
+            for (uint8_t i = 1; i < num_vertices; i++) {
+                if (polygon[i][Y] < y_min) {
+                    y_min = polygon[i][Y];
+                }
+
+                if (polygon[i][Y] > y_max) {
+                    y_max = polygon[i][Y];
+                }
+            }
+
+            #if (GUARD_BAND_RASTERISING)
+                /* The rasteriser clips the rest of the triangle, within the guard band. */
+                y_min = (y_min < 0) ? 0 : y_min;
+                y_max = (y_max > ((FRAME_NUM_ROWS - 1) << SUBPIXEL_BITS)) ? ((FRAME_NUM_ROWS - 1) << SUBPIXEL_BITS) : y_max;
+            #endif
+
+            /* y increases up the frame whereas bands are counted down it, so the highest vertex is in the first band. */
+            bins[tri_num].first_band = (FRAME_NUM_ROWS - VERTEX_PIXEL(y_max) - 1) / BAND_NUM_ROWS;
+            bins[tri_num].last_band = (FRAME_NUM_ROWS - VERTEX_PIXEL(y_min) - 1) / BAND_NUM_ROWS;
+        }
+    }
+
+    void drawMeshBand(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], const Mesh *mesh, const VertexCache *cache, const TriangleBin *bins, uint8_t band)
+    {
+        ScreenCoord projected[3][2];
+        Triangle2D tri2;
+        VertexCoord polygon[CLIP_MAX_VERTICES][2];
+        uint8_t num_vertices;
+        const uint16_t *indices;
+
+        #if (DEPTH_CLIPPING)
+            Triangle3D tri3;
+            ScreenCoord depth_projected[DEPTH_CLIP_MAX_VERTICES][2];
+            uint8_t num_projected;
+            uint8_t codes[3];
+        #endif
+
+        for (uint16_t tri_num = 0; tri_num < mesh->num_triangles; tri_num++) {
+            if (!bins[tri_num].relative_intensity || (band < bins[tri_num].first_band) || (band > bins[tri_num].last_band)) {
+                continue;
+            }
+
+            tri2.colour = mesh->colours[tri_num];
+            tri2.relative_intensity = bins[tri_num].relative_intensity;
+
+            #if (DEPTH_CLIPPING)
+                /* Triangles crossing the near or far plane are clipped and projected again for each band. */
+                assembleTriangle(mesh, cache, tri_num, &tri3, projected, &tri2);
+
+                depthOutcodes(&tri3, codes);
+
+                if (codes[0] | codes[1] | codes[2]) {
+                    num_projected = clipAndProjectDepth(&tri3, codes, depth_projected);
+
+                    drawDepthClippedPolygon(frame, depth_projected, num_projected, &tri2);
+                    continue;
+                }
+            #endif
+
+            /* Only the projected vertices are needed, the triangle was culled and shaded by bin_mesh(). */
+            indices = mesh->indices[tri_num];
+
+            for (uint8_t i = 0; i < 3; i++) {
+                COPY_2D_VERTEX(projected[i], cache->projected[indices[i]]);
+            }
+
+            num_vertices = clip_triangle(projected, polygon);
+
+            /* Pixels outside of the band are skipped by drawPixel() and drawHorizontalLine(). */
+            drawClippedPolygon(frame, polygon, num_vertices, &tri2);
+        }
+    }
+
+#endif
+
+#if (SCANLINE_RENDERING)
+
+    /* Adds the polygon clipped by clip_triangle() to the edge table, an entry per triangle of its fan. */
+    static void addClippedPolygon(ScanlineTable *table, const VertexCoord polygon[CLIP_MAX_VERTICES][2], uint8_t num_vertices, Triangle2D *tri2)
+    {
+        for (uint8_t i = 0; i + 2 < num_vertices; i++) {
+            clip_fan_triangle(polygon, i, tri2);
+            scanline_add_triangle(table, tri2);
+        }
+    }
+
+    void scanline_mesh(const Mesh *mesh, const VertexCache *cache, ScanlineTable *table, uint8_t cull_mode)
+    {
+        Triangle3D tri3;
+        ScreenCoord projected[3][2];
+        Triangle2D tri2;
+        VertexCoord polygon[CLIP_MAX_VERTICES][2];
+        uint8_t num_vertices;
+
+        #if (DEPTH_CLIPPING)
+            ScreenCoord depth_projected[DEPTH_CLIP_MAX_VERTICES][2];
+            uint8_t num_projected;
+            uint8_t codes[3];
+        #endif
+
+        for (uint16_t tri_num = 0; tri_num < mesh->num_triangles; tri_num++) {
+            assembleTriangle(mesh, cache, tri_num, &tri3, projected, &tri2);
+
+            #if (DEPTH_CLIPPING)
+                if (depthOutcodes(&tri3, codes)) {
+                    continue;
+                }
+
+                /* As in drawAssembledTriangle(), each triangle of the fan is clipped to the frame in turn. */
+                if (codes[0] | codes[1] | codes[2]) {
+                    num_projected = clipAndProjectDepth(&tri3, codes, depth_projected);
+
+                    if (!cullAndShadeTriangle(&tri3, depth_projected, num_projected, &tri2, cull_mode)) {
+                        continue;
+                    }
+
+                    for (uint8_t i = 0; i + 2 < num_projected; i++) {
+                        depthFanTriangle(depth_projected, i, projected);
+
+                        num_vertices = clip_triangle(projected, polygon);
+                        addClippedPolygon(table, polygon, num_vertices, &tri2);
+                    }
+
+                    continue;
+                }
+            #endif
+
+            /* As in drawAssembledTriangle(), culled before it is clipped. */
+            if (!cullAndShadeTriangle(&tri3, projected, 3, &tri2, cull_mode)) {
+                continue;
+            }
+
+            num_vertices = clip_triangle(projected, polygon);
+            addClippedPolygon(table, polygon, num_vertices, &tri2);
+        }
+    }
+
+#endif
+
+void drawMeshUncached(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], const Mesh *mesh, const ModelView *mv, uint8_t cull_mode)
+{
+    Triangle3D tri3;
+    ScreenCoord projected[3][2];
+    Triangle2D tri2;
+    Scalar v[3];
+    int16_t position[3] = {0, 0, 0}; /* Unused, the mesh cannot be delta coded. */
+    const uint16_t *indices;
+
+    /* Delta coded vertices can only be decoded in order, not by index, so such meshes are not drawn. */
+    if (mesh->delta_coded) {
+        return;
+    }
+
+    for (uint16_t tri_num = 0; tri_num < mesh->num_triangles; tri_num++) {
+        indices = mesh->indices[tri_num];
+
+        /* Decode, transform and project the triangle's vertices straight from flash. */
+        for (uint8_t i = 0; i < 3; i++) {
+            mesh_decode_vertex(mesh, indices[i], position, v);
+
+            transform_vertex(mv, v, tri3.vs[i]);
+
+            #if (DEPTH_CLIPPING)
+                /* As in transform_mesh(). */
+                if (depth_outcode(tri3.vs[i])) {
+                    continue;
+                }
+            #endif
+
+            project_vertex(tri3.vs[i], projected[i]);
+        }
+
+        tri2.colour = mesh->colours[tri_num];
+
+        drawAssembledTriangle(frame, &tri3, projected, &tri2, cull_mode);
+    }
+}
+
+void printCullingCounts(uint32_t num_frames)
+{
+    /* Division can be truncated safely. */
+    warpPrint("Triangles culled per frame: %d.\n", trianglesCulled / num_frames);
+
+    trianglesCulled = 0;
+}
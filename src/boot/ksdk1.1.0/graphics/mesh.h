@@ -0,0 +1,143 @@
+#ifndef STDINT
+	#include <stdint.h>
+	#define STDINT
+#endif
+
+#ifndef GRAPHICS
+	#include "graphics.h"
+	#define GRAPHICS
+#endif
+
+#ifndef SCANLINE
+	#include "scanline.h"
+	#define SCANLINE
+#endif
+
+/*
+    The formats in which mesh vertices may be stored.
+
+    The integer formats are quantised. Each component is stored as a signed integer and is multiplied
+    by the scale of the mesh when it is decoded, for example -127 -> 127 mapping to -L -> L. Reading 1
+    or 2 bytes per component instead of the 4 of a Scalar shrinks the mesh in flash (and the flash
+    wait states spent reading it) such that meshes of hundreds of triangles fit alongside the firmware.
+*/
+typedef enum {
+    MESH_VERTEX_SCALAR = 0,     /* Scalar components, used as they are. scale is ignored. */
+    MESH_VERTEX_INT8 = 1,       /* int8_t components. */
+    MESH_VERTEX_INT16 = 2,      /* int16_t components. */
+} MeshVertexFormat;
+
+/*
+    The faces of the triangles of a mesh that are not drawn, by which way they face the camera. A triangle is
+    front facing if its vertices wind anticlockwise as seen from the camera, its normal pointing at the camera.
+*/
+typedef enum {
+    CULL_NONE = 0,              /* For double sided objects such as the square. */
+    CULL_BACK = 1,              /* For closed meshes such as the cube, whose back faces are hidden. */
+    CULL_FRONT = 2
+} CullMode;
+
+/*
+    An indexed triangle mesh, stored in FLASH/ROM.
+
+    Closed meshes share most of their vertices between triangles - a cube has 8 unique vertices
+    but 12 triangles reference 36. Therefore, the unique vertices are stored once and each triangle
+    is three indices into that array. This shrinks the flash used by the mesh and, more importantly,
+    allows each unique vertex to be transformed and projected only once per frame (see VertexCache).
+
+    Triangles must be defined by the right hand rule such that their normals point outwards.
+
+    Integer vertices may also be delta coded. That is, each vertex is stored as its difference from the
+    previous vertex (the first from (0, 0, 0)), which lets smooth meshes use int8_t storage at the precision
+    of int16_t. Positions are accumulated in 16 bits. As delta coded vertices can only be decoded in order,
+    such meshes must be drawn through the VertexCache.
+*/
+typedef struct {
+    uint16_t num_vertices;          /* Must not exceed VERTEX_CACHE_SIZE unless drawn with drawMeshUncached(). */
+    uint16_t num_triangles;
+    uint8_t vertex_format;          /* One of MeshVertexFormat. */
+    uint8_t delta_coded;            /* Non zero if the vertices are delta coded. Integer formats only. */
+    Scalar scale;                   /* Decoded component = stored component * scale. Integer formats only. */
+    const void *vertices;           /* num_vertices [3] arrays of the type given by vertex_format, in -1.0 -> 1.0 space once decoded. */
+    const uint16_t (*indices)[3];   /* num_triangles triples of indices into vertices. */
+    const uint8_t *colours;         /* num_triangles colours, one of those defined in the Colours enum. */
+} Mesh;
+
+/*
+    Per-frame cache of the transformed vertices of a mesh, stored in SRAM.
+
+    vs holds the model-view transformed (camera space) vertices, which are still needed to find the
+    normals of the triangles for culling and shading. projected holds the same vertices in pixel space,
+    before they are clipped. With DEPTH_CLIPPING, vertices beyond the near or far plane are not projected.
+*/
+typedef struct {
+    Scalar vs[VERTEX_CACHE_SIZE][3];
+    ScreenCoord projected[VERTEX_CACHE_SIZE][2];
+} VertexCache;
+
+/*
+    Per-frame bin of a triangle of a mesh for banded rendering, stored in SRAM.
+
+    Culling and shading depend only on the camera space vertices so are done once per frame rather than
+    once per band. The bands covered by the triangle are found from its projected vertices, bands being
+    counted from the top of the frame as they are written to the display in that order.
+*/
+typedef struct {
+    uint8_t relative_intensity;     /* 0 if the triangle has been culled. */
+    uint8_t first_band;
+    uint8_t last_band;
+} TriangleBin;
+
+/*
+    Decodes vertex 'index' of the mesh into result.
+
+    position holds the integer position of the previous vertex for delta coded meshes and is updated,
+    it must be (0, 0, 0) when decoding vertex 0 and vertices must then be decoded in order. It is unused otherwise.
+*/
+void mesh_decode_vertex(const Mesh *mesh, uint16_t index, int16_t position[3], Scalar result[3]);
+
+/* Transforms and projects every unique vertex of the mesh exactly once, storing the results in cache. */
+void transform_mesh(const Mesh *mesh, const ModelView *mv, VertexCache *cache);
+
+/*
+    Assembles the triangles of the mesh from the cache filled by transform_mesh() and draws them.
+    cull_mode, one of CullMode, selects the triangles that are not drawn by the way that they face.
+    Triangles seen edge on are not drawn unless it is CULL_NONE.
+*/
+void drawMesh(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], const Mesh *mesh, const VertexCache *cache, uint8_t cull_mode);
+
+#if (BANDED_RENDERING)
+    /*
+        Culls, shades and bins each triangle of the mesh from the cache filled by transform_mesh().
+        bins must hold num_triangles entries. cull_mode is as in drawMesh().
+    */
+    void bin_mesh(const Mesh *mesh, const VertexCache *cache, TriangleBin *bins, uint8_t cull_mode);
+
+    /*
+        Draws the triangles binned into 'band' by bin_mesh(). band_first_row must already be set to the
+        first row of the band, band * BAND_NUM_ROWS.
+    */
+    void drawMeshBand(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], const Mesh *mesh, const VertexCache *cache, const TriangleBin *bins, uint8_t band);
+#endif
+
+#if (SCANLINE_RENDERING)
+    /*
+        Culls and shades each triangle of the mesh from the cache filled by transform_mesh() and adds the
+        visible triangles to the edge table, which must have been emptied with scanline_reset().
+        cull_mode is as in drawMesh().
+    */
+    void scanline_mesh(const Mesh *mesh, const VertexCache *cache, ScanlineTable *table, uint8_t cull_mode);
+#endif
+
+/* Triangles culled by drawMesh() and the functions like it, counted for printCullingCounts(). */
+extern uint32_t trianglesCulled;
+
+/* Prints the average triangles culled per frame over num_frames frames, then resets the count. */
+void printCullingCounts(uint32_t num_frames);
+
+/*
+    As drawMesh() but for meshes with more vertices than fit in the VertexCache. The three vertices of
+    each triangle are decoded, transformed and projected as the triangle is drawn, so shared vertices
+    are transformed more than once. Delta coded meshes cannot be drawn this way, nothing is drawn of them.
+*/
+void drawMeshUncached(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], const Mesh *mesh, const ModelView *mv, uint8_t cull_mode);
@@ -34,6 +34,15 @@ DONT DO PAINTERS ALGORITHM / Concave shapes - not too embedded related!
 Do another convex shape, something like this? <=>
 */
 
+#if (SCREEN_CLIPPING)
+    /* The extent of the guard band about the centre of the frame in normalised coordinates, in which the frame spans 1. */
+    #define GUARD_BAND_NORMALISED(num_pixels) SCALAR( (float) (GUARD_BAND_LIMIT >> SUBPIXEL_BITS) / (num_pixels) )
+
+    #define SATURATE_TO_GUARD_BAND(c, num_pixels) \
+        ( ((c) > GUARD_BAND_NORMALISED(num_pixels)) ? GUARD_BAND_NORMALISED(num_pixels) : \
+            (((c) < -GUARD_BAND_NORMALISED(num_pixels)) ? -GUARD_BAND_NORMALISED(num_pixels) : (c)) )
+#endif
+
 const uint8_t sine_lookup[256] =
 {
 128,131,134,137,140,143,146,149,
@@ -72,8 +81,8 @@ const uint8_t sine_lookup[256] =
 
 void find_triangle_normal(Triangle3D *tri3)
 {
-    float line1[3];
-    float line2[3];
+    Scalar line1[3];
+    Scalar line2[3];
     
     /* Extract two lines of the triangle. */
     line1[X] = tri3->vs[1][X] - tri3->vs[0][X];
@@ -85,30 +94,36 @@ void find_triangle_normal(Triangle3D *tri3)
     line2[Z] = tri3->vs[2][Z] - tri3->vs[0][Z];
 
     /* Find line normal to both lines. */
-    cross_product_float_3d(line1, line2, tri3->normal);
+    CROSS_PRODUCT_3D(line1, line2, tri3->normal);
 }
 
-void z_translate(Triangle3D *tri3)
+void model_view_identity(ModelView *mv)
 {
-    tri3->vs[0][Z] += Z_TRANSLATION;
-	tri3->vs[1][Z] += Z_TRANSLATION;
-	tri3->vs[2][Z] += Z_TRANSLATION;
+    for (uint8_t i = 0; i < 3; i++) {
+        for (uint8_t j = 0; j < 3; j++) {
+            mv->m.m[i][j] = (i == j) ? SCALAR_COEFF(1) : SCALAR_COEFF(0);
+        }
+
+        mv->translation[i] = SCALAR(0);
+    }
 }
 
-void rotate(Triangle3D *tri3, uint8_t rotation_num)
+void model_view_rotate(ModelView *mv, uint16_t theta, uint16_t phi)
 {
-    /* Used to temporarily hold result of rotation. */
-    float temp[3];
+    /* Rotation matrix and the result of composing it with the current model-view. */
+    Mat3 rotation;
+    Mat3 m;
+    Scalar translation[3];
 
     /* Extract sin(angle) and cos(angle) for both theta and phi. */
-    float sin_theta = SIN_UINT8(ROTATION_RATE_THETA * rotation_num);
-    float cos_theta = COS_UINT8(ROTATION_RATE_THETA * rotation_num);
+    ScalarCoeff sin_theta = SIN_UINT8(theta);
+    ScalarCoeff cos_theta = COS_UINT8(theta);
 
-    float sin_phi = SIN_UINT8(ROTATION_RATE_PHI * rotation_num);
-    float cos_phi = COS_UINT8(ROTATION_RATE_PHI * rotation_num);
+    ScalarCoeff sin_phi = SIN_UINT8(phi);
+    ScalarCoeff cos_phi = COS_UINT8(phi);
 
     /*
-        Operate rotation matrix on vertices of tri3.
+        Build the rotation matrix.
 
         Combining usual Z and X axis rotations, and defining A = cos(theta), B = sin(theta),
         C = cos(phi) and D = sin(phi), we find the following:
@@ -116,10 +131,62 @@ void rotate(Triangle3D *tri3, uint8_t rotation_num)
         ( AD  AC   -B )
           0   BD    A
     */
+    rotation.m[X][X] = cos_phi;
+    rotation.m[X][Y] = -sin_phi;
+    rotation.m[X][Z] = SCALAR_COEFF(0);
+
+    rotation.m[Y][X] = SCALAR_COEFF_MUL(cos_theta, sin_phi);
+    rotation.m[Y][Y] = SCALAR_COEFF_MUL(cos_theta, cos_phi);
+    rotation.m[Y][Z] = -sin_theta;
+
+    rotation.m[Z][X] = SCALAR_COEFF(0);
+    rotation.m[Z][Y] = SCALAR_COEFF_MUL(sin_theta, sin_phi);
+    rotation.m[Z][Z] = cos_theta;
+
+    /* The rotation applies after the current transform, so both the matrix and the translation are rotated. */
+    mat3_mul_mat3(&rotation, &mv->m, &m);
+    mat3_mul_vec3(&rotation, mv->translation, translation);
+
+    mv->m = m;
+    mv->translation[X] = translation[X];
+    mv->translation[Y] = translation[Y];
+    mv->translation[Z] = translation[Z];
+}
+
+void model_view_scale(ModelView *mv, ScalarCoeff scale)
+{
+    for (uint8_t i = 0; i < 3; i++) {
+        for (uint8_t j = 0; j < 3; j++) {
+            mv->m.m[i][j] = SCALAR_COEFF_MUL(scale, mv->m.m[i][j]);
+        }
+
+        mv->translation[i] = SCALAR_COEFF_MUL_SCALAR(scale, mv->translation[i]);
+    }
+}
+
+void model_view_translate(ModelView *mv, Scalar x, Scalar y, Scalar z)
+{
+    mv->translation[X] += x;
+    mv->translation[Y] += y;
+    mv->translation[Z] += z;
+}
+
+void transform_vertex(const ModelView *mv, const Scalar v[3], Scalar result[3])
+{
+    mat3_mul_vec3(&mv->m, v, result);
+
+    result[X] += mv->translation[X];
+    result[Y] += mv->translation[Y];
+    result[Z] += mv->translation[Z];
+}
+
+void transform(Triangle3D *tri3, const ModelView *mv)
+{
+    /* Used to temporarily hold result of the transform. */
+    Scalar temp[3];
+
     for (uint8_t i = 0; i < 3; i++) {
-        temp[X] = (cos_phi * tri3->vs[i][X]) + (-sin_phi * tri3->vs[i][Y]);
-        temp[Y] = (cos_theta * sin_phi * tri3->vs[i][X]) + (cos_theta * cos_phi * tri3->vs[i][Y]) + (-sin_theta * tri3->vs[i][Z]);
-        temp[Z] = (sin_theta * sin_phi * tri3->vs[i][Y]) + (cos_theta * tri3->vs[i][Z]);
+        transform_vertex(mv, tri3->vs[i], temp);
 
         tri3->vs[i][X] = temp[X];
         tri3->vs[i][Y] = temp[Y];
@@ -127,36 +194,124 @@ void rotate(Triangle3D *tri3, uint8_t rotation_num)
     }
 }
 
-void project(Triangle3D tri3, Triangle2D *tri2)
+void project_vertex(const Scalar v[3], ScreenCoord result[2])
 {
-    float cos_theta;
+    Scalar x;
+    Scalar y;
 
-    tri2->colour = tri3.colour;
+    #if (FIXED_POINT_PIPELINE)
+        FixedQ16 z_reciprocal;
+    #endif
 
     /*
         Project the coordinates using a sparse-matrix multiplication of the
         projection matrix. Inspired by discussion at https://community.onelonecoder.com/.
-        The projected coordinates can be stored in tri3 for now for some further processing. Particularly,
-        calculating normals in the interest of relative intensity.
     */
-    for (uint8_t i = 0; i < 3; i++) {
-        tri3.vs[i][X] = ( (A__ * B__ * tri3.vs[i][X]) / (tri3.vs[i][Z]) );
-        tri3.vs[i][Y] = ( (B__ * tri3.vs[i][Y]) / (tri3.vs[i][Z]) );
+    #if (FIXED_POINT_PIPELINE)
 
         /*
-            Finally, generate the 2D Triangle value. multiply it by FRAME_NUM_COLS to get it into
-            pixel space, then translate such that 0,0 is no longer in the centre but the bottom left.
-            Finally cast to uint8_t with rounding.
+            A single reciprocal replaces the two divides. A__ * B__ and B__ are folded into
+            compile time constants.
         */
-        tri2->vs[i][X] = (uint8_t) ( (tri3.vs[i][X] * (float) FRAME_NUM_COLS) + (float) (FRAME_NUM_COLS / 2) + 0.5);
-        tri2->vs[i][Y] = (uint8_t) ( (tri3.vs[i][Y] * (float) FRAME_NUM_ROWS) + (float) (FRAME_NUM_ROWS / 2) + 0.5);
-    }
+        z_reciprocal = fixed_reciprocal_q16(v[Z]);
+
+        x = fixed_mul_q16(fixed_mul_q16(SCALAR(A__ * B__), v[X]), z_reciprocal);
+        y = fixed_mul_q16(fixed_mul_q16(SCALAR(B__), v[Y]), z_reciprocal);
+
+        #if (SCREEN_CLIPPING)
+
+            /*
+                Saturated while still normalised, as scaled to pixels they could overflow. A saturated vertex is
+                distorted, but only vertices very close to the plane of the camera lie so far beyond the frame.
+            */
+            x = SATURATE_TO_GUARD_BAND(x, FRAME_NUM_COLS);
+            y = SATURATE_TO_GUARD_BAND(y, FRAME_NUM_ROWS);
+
+            /* As below. The arithmetic shift floors, so vertices off the frame are rounded as those on it. */
+            x = (x * FRAME_NUM_COLS) + FIXED_Q16_FROM_INT(FRAME_NUM_COLS / 2) + (FIXED_Q16_HALF >> SUBPIXEL_BITS);
+            y = (y * FRAME_NUM_ROWS) + FIXED_Q16_FROM_INT(FRAME_NUM_ROWS / 2) + (FIXED_Q16_HALF >> SUBPIXEL_BITS);
+
+            result[X] = (ScreenCoord) (x >> (FIXED_Q16_FRACTIONAL_BITS - SUBPIXEL_BITS));
+            result[Y] = (ScreenCoord) (y >> (FIXED_Q16_FRACTIONAL_BITS - SUBPIXEL_BITS));
+
+        #else
+
+            /*
+                As below. The integer and SUBPIXEL_BITS fractional bits are extracted after adding half of their
+                last bit such that the result is rounded. The soft-float conversion to an unsigned integer saturates
+                negative values to 0, so the same is done here rather than letting them wrap around.
+            */
+            x = (x * FRAME_NUM_COLS) + FIXED_Q16_FROM_INT(FRAME_NUM_COLS / 2) + (FIXED_Q16_HALF >> SUBPIXEL_BITS);
+            y = (y * FRAME_NUM_ROWS) + FIXED_Q16_FROM_INT(FRAME_NUM_ROWS / 2) + (FIXED_Q16_HALF >> SUBPIXEL_BITS);
+
+            result[X] = (x < 0) ? 0 : (VertexCoord) (x >> (FIXED_Q16_FRACTIONAL_BITS - SUBPIXEL_BITS));
+            result[Y] = (y < 0) ? 0 : (VertexCoord) (y >> (FIXED_Q16_FRACTIONAL_BITS - SUBPIXEL_BITS));
+
+            /*
+                Do not let vertices beyond the far edges of the frame be drawn outside of the frame array.
+                Vertices beyond the near edges are already saturated to 0 above.
+            */
+            if (x >= FIXED_Q16_FROM_INT(FRAME_NUM_COLS)) {
+                result[X] = (FRAME_NUM_COLS - 1) << SUBPIXEL_BITS;
+            }
+
+            if (y >= FIXED_Q16_FROM_INT(FRAME_NUM_ROWS)) {
+                result[Y] = (FRAME_NUM_ROWS - 1) << SUBPIXEL_BITS;
+            }
+
+        #endif
+
+    #else
+
+        x = ( (A__ * B__ * v[X]) / (v[Z]) );
+        y = ( (B__ * v[Y]) / (v[Z]) );
+
+        #if (SCREEN_CLIPPING)
+
+            /* As above. */
+            x = SATURATE_TO_GUARD_BAND(x, FRAME_NUM_COLS);
+            y = SATURATE_TO_GUARD_BAND(y, FRAME_NUM_ROWS);
+
+            x = ( (x * (float) FRAME_NUM_COLS) + (float) (FRAME_NUM_COLS / 2) ) * (float) (1 << SUBPIXEL_BITS);
+            y = ( (y * (float) FRAME_NUM_ROWS) + (float) (FRAME_NUM_ROWS / 2) ) * (float) (1 << SUBPIXEL_BITS);
+
+            /* The conversion truncates towards 0, so vertices off the frame are rounded away from it. */
+            result[X] = (ScreenCoord) ( (x >= 0) ? (x + 0.5) : (x - 0.5) );
+            result[Y] = (ScreenCoord) ( (y >= 0) ? (y + 0.5) : (y - 0.5) );
+
+        #else
+
+            /*
+                Finally, generate the 2D vertex. multiply it by FRAME_NUM_COLS to get it into
+                pixel space, then translate such that 0,0 is no longer in the centre but the bottom left.
+                Finally cast to VertexCoord with rounding, keeping SUBPIXEL_BITS fractional bits.
+            */
+            result[X] = (VertexCoord) ( ((x * (float) FRAME_NUM_COLS) + (float) (FRAME_NUM_COLS / 2)) * (float) (1 << SUBPIXEL_BITS) + 0.5);
+            result[Y] = (VertexCoord) ( ((y * (float) FRAME_NUM_ROWS) + (float) (FRAME_NUM_ROWS / 2)) * (float) (1 << SUBPIXEL_BITS) + 0.5);
+
+            /* As above. */
+            if (result[X] >= (FRAME_NUM_COLS << SUBPIXEL_BITS)) {
+                result[X] = (FRAME_NUM_COLS - 1) << SUBPIXEL_BITS;
+            }
+
+            if (result[Y] >= (FRAME_NUM_ROWS << SUBPIXEL_BITS)) {
+                result[Y] = (FRAME_NUM_ROWS - 1) << SUBPIXEL_BITS;
+            }
+
+        #endif
+
+    #endif
+}
+
+void shade(const Triangle3D *tri3, Triangle2D *tri2)
+{
+    Scalar cos_theta;
 
     /*
         Assume light is travelling isotropically at the camera in the Z axis.
         This is not physical but gives a somewhat realistic view of the object.
 
-        Comes from definition of dot product. tri3.normal and (0.0, 0.0, -1.0) are already
+        Comes from definition of dot product. tri3->normal and (0.0, 0.0, -1.0) are already
         normalised so we do not need to divide by their magnitudes.
 
         The 'off' threshold does not need to be considered as this function should not have even been called
@@ -164,20 +319,31 @@ void project(Triangle3D tri3, Triangle2D *tri2)
 
         Remember, at this point, the normal vector is *not* normalised, this allows for correct intensity scaling.
     */
-    cos_theta = (tri3.normal[Z] * -1.0);
+    cos_theta = -tri3->normal[Z];
 
     /* Simple implementation of fabs(cos_theta). */
-    if (cos_theta < 0.0) {
-        cos_theta *= -1.0;
+    if (cos_theta < SCALAR(0)) {
+        cos_theta = -cos_theta;
     }
 
-    if (cos_theta < RELATIVE_INTENSITY_1_THRESHOLD) {
+    if (cos_theta < SCALAR(RELATIVE_INTENSITY_1_THRESHOLD)) {
         tri2->relative_intensity = RELATIVE_INTENSITY_1;
 
-    } else if (cos_theta < RELATIVE_INTENSITY_2_THRESHOLD) {
+    } else if (cos_theta < SCALAR(RELATIVE_INTENSITY_2_THRESHOLD)) {
         tri2->relative_intensity = RELATIVE_INTENSITY_2;
 
     } else {
         tri2->relative_intensity = RELATIVE_INTENSITY_3;
     }
-}
\ No newline at end of file
+}
+
+void project(Triangle3D tri3, ScreenCoord vs[3][2], Triangle2D *tri2)
+{
+    tri2->colour = tri3.colour;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        project_vertex(tri3.vs[i], vs[i]);
+    }
+
+    shade(&tri3, tri2);
+}
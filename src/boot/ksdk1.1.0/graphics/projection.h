@@ -20,40 +20,96 @@
 */
 #define B__ 1.0
 
-#define SIN_UINT8(x) \
-	(float) ( (((float) sine_lookup[x % 255]) - 128.0) / 128.0 )
+/*
+    The sine lookup table stores sin(x) as 128 + 128 * sin(x), that is, with 7 fractional bits.
+    In the fixed point pipeline this is converted exactly to Q8.8 by removing the offset and doubling.
+*/
+#if (FIXED_POINT_PIPELINE)
+
+    #define SIN_UINT8(x) \
+        (FixedQ8) ( (((int16_t) sine_lookup[x % 255]) - 128) * 2 )
+
+    #define COS_UINT8(x) \
+        (FixedQ8) ( (((int16_t) sine_lookup[(uint8_t) (64 - x) % 255]) - 128) * 2 )
 
-#define COS_UINT8(x) \
-	(float) ( (((float) sine_lookup[(uint8_t) (64 - x) % 255]) - 128.0) / 128.0 )
+#else
+
+    #define SIN_UINT8(x) \
+        (float) ( (((float) sine_lookup[x % 255]) - 128.0f) / 128.0f )
+
+    #define COS_UINT8(x) \
+        (float) ( (((float) sine_lookup[(uint8_t) (64 - x) % 255]) - 128.0f) / 128.0f )
+
+#endif
 
 /*
-    Translate a 3D triangle into the z axis such that is not centred around
+    The model-view transform is built once per frame and then applied to every vertex of that frame,
+    such that the trigonometry and the matrix products are not repeated per triangle.
+
+    Each of the model_view_rotate/scale/translate functions applies its transform AFTER those
+    already held in the model-view. For example, identity -> rotate -> translate rotates the
+    object about its own centre and then moves it away from the camera.
+*/
+
+/* Resets the model-view to the identity transform. */
+void model_view_identity(ModelView *mv);
+
+/*
+    Rotates about the X axis by theta, having first rotated about the Z axis by phi. Both angles are
+    analagous to their use in spherical coordinates, that is, phi is the azimuthal angle.
+
+    Each angle can be thought of as a similar quantity to an angle. However, instead of
+    ranging from 0 -> 360 or 0 -> 2\pi, it ranges from 0->255 such that it
+    matches up with the uint8_t datatype and the sine lookup table implemented
+    in projection.c. Larger values are wrapped by the lookup.
+*/
+void model_view_rotate(ModelView *mv, uint16_t theta, uint16_t phi);
+
+/* Uniformly scales about the origin. */
+void model_view_scale(ModelView *mv, ScalarCoeff scale);
+
+/*
+    Translates by (x, y, z).
+
+    Used to translate the scene into the z axis such that is not centred around
     (0, 0, 0). Rendering at z = 0 is undefined and rendering at z < 1 will quickly ensure 
     that the triangle extends beyond the bound of the screen. Therefore,
     being that rendered shapes are defined in the range (-1.0 -> 1.0) in every axis, is is recommended
-    that Z_TRANSLATION is no less than 2.0 such that points defined at z = -1.0 still render at least 
-    at z = 1.0.
+    that the z translation (Z_TRANSLATION in the demos) is no less than 2.0 such that points defined
+    at z = -1.0 still render at least at z = 1.0.
     Summary:
-        Z_TRANSLATION *MUST* be greater than 1.0 (not inclusive)
-        Z_TRANSLATION should be greater or equal to 2.0 to ensure vertices do not extend beyond the bounds of the screen.
+        z *MUST* be greater than 1.0 (not inclusive)
+        z should be greater or equal to 2.0 to ensure vertices do not extend beyond the bounds of the screen.
+
+    With NEAR_PLANE_CLIPPING, the mesh demos clip triangles to z = NEAR_PLANE_Z instead, so z may be anything.
 */
-void z_translate(Triangle3D *tri3);
+void model_view_translate(ModelView *mv, Scalar x, Scalar y, Scalar z);
+
+/* Transforms the vertex v by the model-view, storing the result in result. result must not alias v. */
+void transform_vertex(const ModelView *mv, const Scalar v[3], Scalar result[3]);
+
+/* Transforms the three vertices of a 3D triangle by the model-view. */
+void transform(Triangle3D *tri3, const ModelView *mv);
 
 /*
-    Rotates a 3D triangle in 3D space. 'rotation_num' can be
-    thought of as a similar quantity to an angle. However, instead of
-    ranging from 0 -> 360 or 0 -> 2\pi, it ranges from 0->255 such that it
-    matches up with the uint8_t datatype and the sine lookup table implemented
-    in projection.c.
+    Perspectively projects the camera space vertex v into pixel space, storing the result in result.
+    Coordinates keep SUBPIXEL_BITS fractional bits. They are clamped to the frame or, with screen-space clipping,
+    saturated to the guard band. v must have z > 0, with NEAR_PLANE_CLIPPING z >= NEAR_PLANE_Z.
+*/
+void project_vertex(const Scalar v[3], ScreenCoord result[2]);
+
+/*
+    Calculates the relative intensity that the 2D triangle tri2 should be displayed with
+    from the normal of tri3. find_triangle_normal() must have been called on tri3.
 */
-void rotate(Triangle3D *tri3, uint8_t rotation_num);
+void shade(const Triangle3D *tri3, Triangle2D *tri2);
 
 /*
-    Perspectively projects the 3D tri3 into 2D, storing the result in tri2.
+    Perspectively projects the 3D tri3 into 2D, storing its vertices in vs and its colour in tri2.
     During this process, the relative intensity that the 2D triangle should be
-    displayed with is calculated.
+    displayed with is calculated. vs is clipped with clip_triangle() and drawn with drawClippedPolygon().
 */
-void project(Triangle3D tri3, Triangle2D *tri2);
+void project(Triangle3D tri3, ScreenCoord vs[3][2], Triangle2D *tri2);
 
 /* Find the normal of a triangle defined in 3D. */
 void find_triangle_normal(Triangle3D *tri3);
\ No newline at end of file
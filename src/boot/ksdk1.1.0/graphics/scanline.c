@@ -0,0 +1,222 @@
+#include <stdint.h>
+
+#include "devSSD1331.h"
+#include "scanline.h"
+#include "warp.h"
+
+#if (SCANLINE_RENDERING)
+
+    uint32_t scanlineTrianglesDropped = 0;
+
+    /*
+        Sorts the order of the edge table by top row with an insertion sort.
+        The table is small and usually close to sorted from the previous frame's mesh order.
+    */
+    static void sortScanlineTable(ScanlineTable *table)
+    {
+        uint8_t index;
+        uint8_t top_row;
+        uint8_t j;
+
+        for (uint8_t i = 1; i < table->num_triangles; i++) {
+            index = table->order[i];
+            top_row = table->triangles[index].vs[0][Y];
+
+            for (j = i; (j > 0) && (table->triangles[table->order[j - 1]].vs[0][Y] > top_row); j--) {
+                table->order[j] = table->order[j - 1];
+            }
+
+            table->order[j] = index;
+        }
+    }
+
+    /* Sets up one side of an active triangle to step from vertex v0 to vertex v1, v1 lying on or below v0. */
+    static void setupScanlineSide(const uint8_t v0[2], const uint8_t v1[2], int32_t *x, int32_t *dx)
+    {
+        /* Rounded rather than truncated when converted back to a column. */
+        *x = FIXED_Q16_FROM_INT(v0[X]) + FIXED_Q16_HALF;
+
+        if (v1[Y] == v0[Y]) {
+            *dx = 0;
+        } else {
+            *dx = ( (int32_t) v1[X] - (int32_t) v0[X] ) * FIXED_Q16_ONE / ( v1[Y] - v0[Y] );
+        }
+    }
+
+    /*
+        Moves a triangle from the edge table into the active list.
+
+        The active list is kept in the order in which the triangles were added to the edge table such
+        that later triangles are drawn over earlier ones. Returns 0 if the active list is full.
+    */
+    static uint8_t activateScanlineTriangle(
+        const ScanlineTable *table,
+        uint8_t index,
+        ScanlineActiveTriangle active[SCANLINE_MAX_ACTIVE],
+        uint8_t *num_active
+    )
+    {
+        const ScanlineTriangle *tri = &table->triangles[index];
+        uint8_t i;
+
+        if (*num_active == SCANLINE_MAX_ACTIVE) {
+            return 0;
+        }
+
+        for (i = *num_active; (i > 0) && (active[i - 1].triangle > index); i--) {
+            active[i] = active[i - 1];
+        }
+
+        active[i].triangle = index;
+        setupScanlineSide(tri->vs[0], tri->vs[2], &active[i].x_long, &active[i].dx_long);
+        setupScanlineSide(tri->vs[0], tri->vs[1], &active[i].x_short, &active[i].dx_short);
+
+        (*num_active)++;
+
+        return 1;
+    }
+
+    void scanline_reset(ScanlineTable *table)
+    {
+        table->num_triangles = 0;
+    }
+
+    void scanline_add_triangle(ScanlineTable *table, const Triangle2D *tri)
+    {
+        ScanlineTriangle *entry;
+        uint8_t temp[2];
+
+        if (table->num_triangles == NUM_TRIANGLES) {
+            scanlineTrianglesDropped++;
+            return;
+        }
+
+        entry = &table->triangles[table->num_triangles];
+
+        /* Convert y to a C style row such that the vertices are sorted from the top of the frame. */
+        for (uint8_t i = 0; i < 3; i++) {
+            entry->vs[i][X] = tri->vs[i][X];
+            entry->vs[i][Y] = FRAME_NUM_ROWS - tri->vs[i][Y] - 1;
+        }
+
+        for (uint8_t i = 0; i < 2; i++) {
+            for (uint8_t j = 0; j < 2 - i; j++) {
+                if (entry->vs[j][Y] > entry->vs[j + 1][Y]) {
+                    COPY_2D_VERTEX(temp, entry->vs[j]);
+                    COPY_2D_VERTEX(entry->vs[j], entry->vs[j + 1]);
+                    COPY_2D_VERTEX(entry->vs[j + 1], temp);
+                }
+            }
+        }
+
+        /* Found once per triangle rather than once per pixel. */
+        entry->colour = pixelValueToColour(tri->colour + (tri->relative_intensity << PIXELS_PER_BYTE));
+
+        table->order[table->num_triangles] = table->num_triangles;
+        table->num_triangles++;
+    }
+
+    void renderScanlines(ScanlineTable *table)
+    {
+        ScanlineActiveTriangle active[SCANLINE_MAX_ACTIVE];
+        uint8_t num_active = 0;
+        uint8_t next = 0;   /* Position in the order of the next triangle to become active. */
+
+        /* One row of the frame in the display's 16 bit colour format, MSB first as it is sent. */
+        uint8_t scanline[2 * FRAME_NUM_COLS];
+
+        const ScanlineTriangle *tri;
+        ScanlineActiveTriangle *side;
+        uint8_t xA;
+        uint8_t xB;
+        uint8_t i;
+
+        sortScanlineTable(table);
+
+        for (uint8_t row = 0; row < FRAME_NUM_ROWS; row++) {
+
+            /* Triangles enter the active list on their top row. */
+            while ( (next < table->num_triangles) && (table->triangles[table->order[next]].vs[0][Y] <= row) ) {
+                if (!activateScanlineTriangle(table, table->order[next], active, &num_active)) {
+                    scanlineTrianglesDropped++;
+                }
+
+                next++;
+            }
+
+            /* MEMSET not used as to avoid introduction of string.h. */
+            for (uint8_t col = 0; col < 2 * FRAME_NUM_COLS; col++) {
+                scanline[col] = 0;
+            }
+
+            i = 0;
+
+            while (i < num_active) {
+                side = &active[i];
+                tri = &table->triangles[side->triangle];
+
+                /* The short side turns at the middle vertex. */
+                if (row == tri->vs[1][Y]) {
+                    setupScanlineSide(tri->vs[1], tri->vs[2], &side->x_short, &side->dx_short);
+                }
+
+                if (tri->vs[0][Y] == tri->vs[2][Y]) {
+                    /* The whole triangle lies on this row, so neither side reaches the third vertex. */
+                    xA = tri->vs[0][X];
+                    xB = tri->vs[0][X];
+
+                    for (uint8_t v = 1; v < 3; v++) {
+                        if (tri->vs[v][X] < xA) {
+                            xA = tri->vs[v][X];
+                        }
+
+                        if (tri->vs[v][X] > xB) {
+                            xB = tri->vs[v][X];
+                        }
+                    }
+
+                } else {
+                    xA = side->x_long >> FIXED_Q16_FRACTIONAL_BITS;
+                    xB = side->x_short >> FIXED_Q16_FRACTIONAL_BITS;
+
+                    if (xA > xB) {
+                        uint8_t temp = xA;
+                        xA = xB;
+                        xB = temp;
+                    }
+                }
+
+                for (uint8_t x = xA; x <= xB; x++) {
+                    scanline[2 * x] = (0xFF00 & tri->colour) >> 8;  /* MSB. */
+                    scanline[2 * x + 1] = (0xFF & tri->colour);     /* LSB. */
+                }
+
+                /* Triangles leave the active list after their bottom row. */
+                if (row == tri->vs[2][Y]) {
+                    num_active--;
+
+                    for (uint8_t j = i; j < num_active; j++) {
+                        active[j] = active[j + 1];
+                    }
+
+                    continue;
+                }
+
+                side->x_long += side->dx_long;
+                side->x_short += side->dx_short;
+                i++;
+            }
+
+            writeScanline(scanline);
+        }
+    }
+
+    void printScanlineCounts(uint32_t num_frames)
+    {
+        /* A total rather than per frame, as a single dropped triangle is a visible error. */
+        warpPrint("Triangles dropped by scanline rendering in %d frames: %d.\n", num_frames, scanlineTrianglesDropped);
+
+        scanlineTrianglesDropped = 0;
+    }
+
+#endif
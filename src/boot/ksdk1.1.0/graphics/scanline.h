@@ -0,0 +1,74 @@
+#ifndef STDINT
+	#include <stdint.h>
+	#define STDINT
+#endif
+
+#ifndef GRAPHICS
+	#include "graphics.h"
+	#define GRAPHICS
+#endif
+
+#if (SCANLINE_RENDERING)
+
+    /*
+        A triangle in the edge table.
+
+        vs holds the vertices with their y coordinates converted to C style rows, counted from the top of the frame.
+        They are sorted in ascending row, so vs[0] is the top vertex.
+        colour is the 16 bit display colour of the triangle, found once from its colour and relative intensity.
+    */
+    typedef struct {
+        uint8_t vs[3][2];
+        uint16_t colour;
+    } ScanlineTriangle;
+
+    /*
+        The edge table of a frame. order holds the indices of the triangles sorted by their top row, which is the
+        order in which they become active. Triangles are otherwise kept in the order in which they were added so that
+        later triangles are drawn over earlier ones, as with drawTriangle().
+    */
+    typedef struct {
+        ScanlineTriangle triangles[NUM_TRIANGLES];
+        uint8_t order[NUM_TRIANGLES];
+        uint8_t num_triangles;
+    } ScanlineTable;
+
+    /*
+        A triangle in the active list, holding the current x of its two sides in Q16.16.
+
+        The long side runs from the top vertex to the bottom vertex. The short side runs from the top vertex to the
+        middle vertex and then on to the bottom vertex. x is stepped by dx for each row moved down the frame.
+    */
+    typedef struct {
+        int32_t x_long;
+        int32_t dx_long;
+        int32_t x_short;
+        int32_t dx_short;
+        uint8_t triangle;   /* Index into the triangles of the ScanlineTable. */
+    } ScanlineActiveTriangle;
+
+    /* Empties the edge table. Must be called at the start of each frame. */
+    void scanline_reset(ScanlineTable *table);
+
+    /*
+        Adds a shaded, projected triangle to the edge table.
+        Triangles beyond NUM_TRIANGLES are not drawn, and are counted in scanlineTrianglesDropped.
+    */
+    void scanline_add_triangle(ScanlineTable *table, const Triangle2D *tri);
+
+    /*
+        Generates the frame one row at a time from the top and writes each row to the display with writeScanline().
+        No frame array is used.
+    */
+    void renderScanlines(ScanlineTable *table);
+
+    /*
+        Triangles not drawn as the edge table was full or, in renderScanlines(), as more than SCANLINE_MAX_ACTIVE
+        crossed a row, counted for printScanlineCounts().
+    */
+    extern uint32_t scanlineTrianglesDropped;
+
+    /* Prints the triangles dropped over num_frames frames, then resets the count. */
+    void printScanlineCounts(uint32_t num_frames);
+
+#endif
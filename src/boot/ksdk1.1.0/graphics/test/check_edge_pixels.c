@@ -0,0 +1,132 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "gdram_sim.h"
+
+/*
+    Compares GDRAM as written by two runs of demo_frames.c, for the scanline renderer against a reference that samples
+    pixel centres, the half-space rasteriser.
+
+        check_edge_pixels REFERENCE_PIXELS CANDIDATE_PIXELS
+
+    The scanline renderer fills every row of a triangle from its top vertex to its bottom vertex, inclusive, between
+    the crossings of its two sides rounded to the nearest column. Where the reference draws a pixel of a triangle, so
+    does the candidate, but the candidate may also draw
+
+        - the column beyond either end of a span, where a crossing rounds outwards,
+        - the row of a horizontal edge through pixel centres, which the top-left rule leaves to the triangle beyond it,
+          and the pixel at the corner of the two,
+        - the pixels across a triangle narrower than a pixel, which may cover no pixel centre at all. Rounding the
+          two crossings gives at most two of them.
+
+    So a pixel of the candidate may differ from that of the reference only if its value in the candidate is the value
+    in the reference of one of its 8 neighbours, or if the pixels of its value in the candidate run through it for at
+    most two pixels along its row or its column. Fails if a pixel does not, or if the runs differ in length.
+*/
+
+static uint16_t pixels[2][GDRAM_SIM_ROWS][GDRAM_SIM_COLS];
+
+/* Returns 1 if one of the 8 neighbours of (row, col) holds value in the reference, or 0. */
+static uint8_t neighbourHolds(int row, int col, uint16_t value)
+{
+    for (int r = row - 1; r <= row + 1; r++) {
+        for (int c = col - 1; c <= col + 1; c++) {
+            if ( (r >= 0) && (r < GDRAM_SIM_ROWS) && (c >= 0) && (c < GDRAM_SIM_COLS) && (pixels[0][r][c] == value) ) {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* Returns the length of the run of the value of (row, col) in the candidate through it, along its row or column. */
+static int runLength(int row, int col, int row_step, int col_step)
+{
+    uint16_t value = pixels[1][row][col];
+    int length = 1;
+
+    for (int direction = -1; direction <= 1; direction += 2) {
+        int r = row + direction * row_step;
+        int c = col + direction * col_step;
+
+        while ( (r >= 0) && (r < GDRAM_SIM_ROWS) && (c >= 0) && (c < GDRAM_SIM_COLS) && (pixels[1][r][c] == value) ) {
+            length++;
+            r += direction * row_step;
+            c += direction * col_step;
+        }
+    }
+
+    return length;
+}
+
+int main(int argc, char **argv)
+{
+    FILE *files[2];
+    uint32_t num_frames = 0;
+    uint32_t frames_different = 0;
+    uint32_t pixels_different = 0;
+    uint32_t num_failures = 0;
+    size_t num_read[2];
+
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s REFERENCE_PIXELS CANDIDATE_PIXELS\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        files[i] = fopen(argv[1 + i], "rb");
+
+        if (files[i] == NULL) {
+            perror(argv[1 + i]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (;;) {
+        uint8_t different = 0;
+
+        for (int i = 0; i < 2; i++) {
+            num_read[i] = fread(pixels[i], sizeof(pixels[i]), 1, files[i]);
+        }
+
+        if ( (num_read[0] == 0) && (num_read[1] == 0) ) {
+            break;
+        }
+
+        if ( (num_read[0] != 1) || (num_read[1] != 1) ) {
+            printf("The runs differ in length, or a file is cut short, at frame %u.\n", (unsigned int) num_frames);
+            return EXIT_FAILURE;
+        }
+
+        for (int row = 0; row < GDRAM_SIM_ROWS; row++) {
+            for (int col = 0; col < GDRAM_SIM_COLS; col++) {
+                if (pixels[0][row][col] == pixels[1][row][col]) {
+                    continue;
+                }
+
+                different = 1;
+                pixels_different++;
+
+                if ( neighbourHolds(row, col, pixels[1][row][col]) || (runLength(row, col, 0, 1) <= 2) ||
+                    (runLength(row, col, 1, 0) <= 2) ) {
+                    continue;
+                }
+
+                if (num_failures++ < 10) {
+                    printf("Pixel (%d, %d) of frame %u is %04x rather than %04x, which the edge rules do not explain.\n",
+                        row, col, (unsigned int) num_frames, pixels[1][row][col], pixels[0][row][col]);
+                }
+            }
+        }
+
+        frames_different += different;
+        num_frames++;
+    }
+
+    printf("%u of %u frames differ, in %u pixels, %u of them not explained.\n", (unsigned int) frames_different,
+        (unsigned int) num_frames, (unsigned int) pixels_different, (unsigned int) num_failures);
+
+    return ( (num_failures == 0) && (num_frames > 0) ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
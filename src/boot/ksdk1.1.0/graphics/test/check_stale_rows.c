@@ -0,0 +1,93 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "gdram_sim.h"
+
+/*
+    Compares the row hashes written by two runs of demo_frames.c, for a candidate that may leave rows of the display
+    stale for a while, as row signatures do on a collision.
+
+        check_stale_rows REFERENCE_ROWS CANDIDATE_ROWS MAX_STALE_FRAMES
+
+    Fails if a row of the candidate differs from that of the reference for more than MAX_STALE_FRAMES frames in a
+    row, or the runs differ in length.
+*/
+
+int main(int argc, char **argv)
+{
+    FILE *files[2];
+    unsigned int hashes[2][GDRAM_SIM_ROWS];
+    uint32_t stale_for[GDRAM_SIM_ROWS] = {0};
+    uint32_t max_stale_frames;
+    uint32_t longest = 0;
+    uint32_t num_frames = 0;
+    uint32_t frames_different = 0;
+    uint32_t num_failures = 0;
+    int num_read[2];
+
+    if (argc != 4) {
+        fprintf(stderr, "Usage: %s REFERENCE_ROWS CANDIDATE_ROWS MAX_STALE_FRAMES\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    max_stale_frames = strtoul(argv[3], NULL, 10);
+
+    for (int i = 0; i < 2; i++) {
+        files[i] = fopen(argv[1 + i], "r");
+
+        if (files[i] == NULL) {
+            perror(argv[1 + i]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (;;) {
+        uint8_t different = 0;
+
+        for (int i = 0; i < 2; i++) {
+            num_read[i] = 0;
+
+            while ( (num_read[i] < GDRAM_SIM_ROWS) && (fscanf(files[i], "%x", &hashes[i][num_read[i]]) == 1) ) {
+                num_read[i]++;
+            }
+        }
+
+        if ( (num_read[0] == 0) && (num_read[1] == 0) ) {
+            break;
+        }
+
+        if ( (num_read[0] != GDRAM_SIM_ROWS) || (num_read[1] != GDRAM_SIM_ROWS) ) {
+            printf("The runs differ in length, or a file is cut short, at frame %u.\n", (unsigned int) num_frames);
+            return EXIT_FAILURE;
+        }
+
+        for (int row = 0; row < GDRAM_SIM_ROWS; row++) {
+            if (hashes[0][row] == hashes[1][row]) {
+                stale_for[row] = 0;
+                continue;
+            }
+
+            different = 1;
+
+            if (++stale_for[row] > longest) {
+                longest = stale_for[row];
+            }
+
+            if (stale_for[row] == max_stale_frames + 1) {
+                if (num_failures++ < 10) {
+                    printf("Row %d is stale for more than %u frames at frame %u.\n", row,
+                        (unsigned int) max_stale_frames, (unsigned int) num_frames);
+                }
+            }
+        }
+
+        frames_different += different;
+        num_frames++;
+    }
+
+    printf("%u of %u frames differ, rows stale for at most %u frames in a row, against a bound of %u.\n",
+        (unsigned int) frames_different, (unsigned int) num_frames, (unsigned int) longest, (unsigned int) max_stale_frames);
+
+    return ( (num_failures == 0) && (num_frames > 0) ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
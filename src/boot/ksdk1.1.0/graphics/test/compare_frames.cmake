@@ -0,0 +1,106 @@
+# Runs two builds of demo_frames.c and checks that they send the same frames to the simulated display.
+#
+#   cmake -DREFERENCE=<demo> -DCANDIDATE=<demo> -DNAME=<test> -P compare_frames.cmake
+#
+# Each writes a hash of GDRAM per frame to <test>.<reference|candidate>.txt in the working directory. The test fails
+# if either run fails or the hashes differ, naming the first frame that does.
+#
+# With -DCHECKER=<check_stale_rows> -DMAX_STALE_FRAMES=<n>, the rows of the candidate may instead differ for up to n
+# frames in a row, as checked by check_stale_rows.c from the row hashes written to <test>.<...>.rows.txt.
+#
+# With -DPIXEL_CHECKER=<check_edge_pixels>, the pixels of the candidate may instead differ where an edge is sampled
+# differently, as checked by check_edge_pixels.c from GDRAM written to <test>.<...>.pixels, which is then removed.
+
+foreach(run REFERENCE CANDIDATE)
+    string(TOLOWER ${run} suffix)
+    set(hashes_${run} ${NAME}.${suffix}.txt)
+    set(row_hashes_${run})
+    set(pixels_${run})
+
+    if(DEFINED CHECKER)
+        set(row_hashes_${run} ${NAME}.${suffix}.rows.txt)
+    endif()
+
+    if(DEFINED PIXEL_CHECKER)
+        set(row_hashes_${run} ${NAME}.${suffix}.rows.txt)
+        set(pixels_${run} ${NAME}.${suffix}.pixels)
+    endif()
+
+    execute_process(
+        COMMAND ${${run}} ${hashes_${run}} ${row_hashes_${run}} ${pixels_${run}}
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE output
+    )
+
+    message("${${run}}:\n${output}")
+
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "${${run}} failed: ${result}")
+    endif()
+
+    file(STRINGS ${hashes_${run}} frames_${run})
+endforeach()
+
+list(LENGTH frames_REFERENCE num_reference)
+list(LENGTH frames_CANDIDATE num_candidate)
+
+if(NOT num_reference EQUAL num_candidate)
+    message(FATAL_ERROR "The reference sent ${num_reference} frames, the candidate ${num_candidate}.")
+endif()
+
+if(num_reference EQUAL 0)
+    message(FATAL_ERROR "No frames were sent.")
+endif()
+
+if(DEFINED CHECKER)
+    execute_process(
+        COMMAND ${CHECKER} ${row_hashes_REFERENCE} ${row_hashes_CANDIDATE} ${MAX_STALE_FRAMES}
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE output
+    )
+
+    message("${output}")
+
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Rows of the candidate were stale for more than ${MAX_STALE_FRAMES} frames.")
+    endif()
+
+    return()
+endif()
+
+if(DEFINED PIXEL_CHECKER)
+    execute_process(
+        COMMAND ${PIXEL_CHECKER} ${pixels_REFERENCE} ${pixels_CANDIDATE}
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE output
+    )
+
+    message("${output}")
+
+    # GDRAM is 12 KiB a frame.
+    file(REMOVE ${pixels_REFERENCE} ${pixels_CANDIDATE})
+
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Pixels of the candidate differ where no edge explains it.")
+    endif()
+
+    return()
+endif()
+
+if(NOT frames_REFERENCE STREQUAL frames_CANDIDATE)
+    math(EXPR last "${num_reference} - 1")
+
+    foreach(frame RANGE ${last})
+        list(GET frames_REFERENCE ${frame} reference)
+        list(GET frames_CANDIDATE ${frame} candidate)
+
+        if(NOT reference STREQUAL candidate)
+            message(FATAL_ERROR "Frame ${frame} of ${num_reference} differs.")
+        endif()
+    endforeach()
+endif()
+
+message("All ${num_reference} frames are the same.")
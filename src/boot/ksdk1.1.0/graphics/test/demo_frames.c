@@ -0,0 +1,379 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "graphics_demo.h"
+#include "display_host.h"
+
+#include "spi_mock.h"
+#include "gdram_sim.h"
+
+/*
+    Runs graphicsDemo(), as configured by graphics.h, against the display driver of DISPLAY_BACKEND. A hash of what
+    the display shows is written to the file named by the first argument after every frame has been sent, one per
+    line, such that two configurations can be compared frame by frame (see compare_frames.cmake).
+
+    With the SSD1331, that is GDRAM of the simulated display of gdram_sim.c. If a second file is named, a hash of each
+    row of GDRAM is also written to it, a line of GDRAM_SIM_ROWS per frame, for check_stale_rows.c. If a third is
+    named, GDRAM itself is written to it, as it is held in gdramSim, for check_edge_pixels.c. With the SSD1306, which
+    is sent the whole frame window whenever it changes, it is the data bytes of the frame, which are not fed to
+    gdram_sim.c. With the host display, it is the PPM image written by hostDisplayFlush(), which is checked against
+    the frame flushed, pixel for pixel, and then removed. The counts of those checked and found to differ are printed
+    at the end.
+
+    The flush of the backend, ssd1331Flush(), ssd1306Flush() or hostDisplayFlush(), is wrapped (-Wl,--wrap) to find
+    the frames. With DISPLAY_VTABLE, display is pointed instead at a copy of its backend whose flush calls
+    flushFrame(). A frame has been sent once CS is next driven high, which with asynchronous scanout is only when the
+    next frame, or the end of the demo, waits for it. With banded rendering, only the flush of the last band ends a
+    frame. With scanline rendering, hardware primitives and direct rendering, the frame is sent as it is drawn and the
+    flush of NULL that follows ends it, unless nothing has been sent since the last.
+
+    The SPI transfers and bytes sent per frame are printed at the end, counted from the first flush such that the
+    initialisation of the display is not included.
+*/
+
+#define FRAMELESS_RENDERING ( (SCANLINE_RENDERING) || (HW_PRIMITIVES) || (DIRECT_RENDERING) )
+
+#if (DISPLAY_VTABLE)
+    /* As in display.h, which declares the SSD1331 driver again after graphics_demo.h. */
+    extern const DisplayBackend *display;
+
+    /* The backend display pointed to, with its flush replaced by flushFrame(). */
+    static DisplayBackend hookedDisplay;
+    static void (*realFlush)(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS]);
+
+    #define FLUSH_WRAPPER flushFrame
+#elif (DISPLAY_BACKEND == DISPLAY_SSD1331)
+    void __real_ssd1331Flush(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS]);
+
+    #define realFlush __real_ssd1331Flush
+    #define FLUSH_WRAPPER __wrap_ssd1331Flush
+#elif (DISPLAY_BACKEND == DISPLAY_SSD1306)
+    void __real_ssd1306Flush(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS]);
+
+    #define realFlush __real_ssd1306Flush
+    #define FLUSH_WRAPPER __wrap_ssd1306Flush
+#else
+    void __real_hostDisplayFlush(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS]);
+
+    #define realFlush __real_hostDisplayFlush
+    #define FLUSH_WRAPPER __wrap_hostDisplayFlush
+#endif
+
+void FLUSH_WRAPPER(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS]);
+
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+static FILE *hashes;
+static FILE *rowHashes = NULL;
+static FILE *pixels = NULL;
+static uint32_t numFrames = 0;
+
+/* Frames flushed but not yet recorded. */
+static uint32_t framesPending = 0;
+
+/* The SPI counts of spi_mock.c at the first flush, or the flag that it has not yet been. */
+static uint8_t flushed = 0;
+static uint32_t firstTransfers;
+static uint32_t firstCommandBytes;
+static uint32_t firstDataBytes;
+static uint32_t firstFrames;
+
+#if (FRAMELESS_RENDERING)
+    /* The bytes sent by the end of the last frame. */
+    static uint32_t lastFrameBytes = 0;
+#endif
+
+#if (DISPLAY_BACKEND != DISPLAY_SSD1331)
+    /* Hash of what the display showed after the last frame sent, for backends other than the SSD1331. */
+    static uint32_t shownHash = FNV_OFFSET_BASIS;
+
+    static uint32_t hashBytes(uint32_t hash, const uint8_t *bytes, size_t num_bytes)
+    {
+        for (size_t i = 0; i < num_bytes; i++) {
+            hash = (hash ^ bytes[i]) * FNV_PRIME;
+        }
+
+        return hash;
+    }
+#endif
+
+#if (DISPLAY_BACKEND == DISPLAY_SSD1306)
+    /* Hash of the data bytes sent since the last frame was recorded, if any have been. */
+    static uint32_t dataHash = FNV_OFFSET_BASIS;
+    static uint8_t dataSent = 0;
+
+    static void hashData(const uint8_t *bytes, size_t num_bytes)
+    {
+        dataHash = hashBytes(dataHash, bytes, num_bytes);
+        dataSent = 1;
+    }
+#endif
+
+#if (DISPLAY_BACKEND == DISPLAY_HOST)
+    /* Images written by hostDisplayFlush(), and those of them that differ from the frame flushed. */
+    static uint32_t imagesChecked = 0;
+    static uint32_t imagesDifferent = 0;
+
+    /*
+        If hostDisplayFlush() has written an image, hashes it into shownHash, checks it against frame, unless NULL,
+        and removes it. Each pixel of the frame must cover RENDER_SCALE x RENDER_SCALE pixels of the image, in its
+        colour at its relative intensity.
+    */
+    static void checkImage(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS])
+    {
+        char name[32];
+        FILE *file;
+        int cols;
+        int rows;
+        int max_value;
+        uint8_t channels[3];
+        uint8_t pixel_value;
+        uint8_t expected;
+        uint8_t different = 0;
+
+        snprintf(name, sizeof(name), HOST_DISPLAY_IMAGE_NAME, (unsigned long) imagesChecked);
+
+        file = fopen(name, "rb");
+
+        if (file == NULL) {
+            /* The image has not changed since the last. */
+            return;
+        }
+
+        imagesChecked++;
+        shownHash = FNV_OFFSET_BASIS;
+
+        if ( (fscanf(file, "P6 %d %d %d", &cols, &rows, &max_value) != 3) || (fgetc(file) != '\n') ||
+            (cols != FRAME_SCREEN_COLS) || (rows != FRAME_SCREEN_ROWS) || (max_value != 255) ) {
+            different = 1;
+        }
+
+        for (uint16_t screen_row = 0; (screen_row < FRAME_SCREEN_ROWS) && !different; screen_row++) {
+            for (uint16_t screen_col = 0; (screen_col < FRAME_SCREEN_COLS) && !different; screen_col++) {
+                if (fread(channels, 1, sizeof(channels), file) != sizeof(channels)) {
+                    different = 1;
+                    break;
+                }
+
+                shownHash = hashBytes(shownHash, channels, sizeof(channels));
+
+                if (frame == NULL) {
+                    continue;
+                }
+
+                pixel_value = get_pixel_value_rowcol(frame, screen_row / RENDER_SCALE, screen_col / RENDER_SCALE);
+
+                /* Colours R, G and B are 1, 2 and 3. */
+                for (uint8_t colour = R; colour <= B; colour++) {
+                    expected = (COLOUR_FROM_PIXEL_VALUE(pixel_value) == colour) ?
+                        (255 * RELATIVE_INTENSITY_FROM_PIXEL_VALUE(pixel_value)) / MAX_RELATIVE_INTENSITY : 0;
+
+                    different |= (channels[colour - R] != expected);
+                }
+            }
+        }
+
+        if ( different || (fgetc(file) != EOF) ) {
+            if (imagesDifferent++ == 0) {
+                printf("%s differs from the frame flushed.\n", name);
+            }
+        }
+
+        fclose(file);
+        remove(name);
+    }
+#endif
+
+static void recordFrame(void)
+{
+    #if (DISPLAY_BACKEND == DISPLAY_SSD1331)
+        fprintf(hashes, "%08x\n", (unsigned int) gdramSimHash());
+    #else
+        #if (DISPLAY_BACKEND == DISPLAY_SSD1306)
+            /* A frame that left the display as it was sends nothing. */
+            if (dataSent) {
+                shownHash = dataHash;
+                dataHash = FNV_OFFSET_BASIS;
+                dataSent = 0;
+            }
+        #endif
+
+        fprintf(hashes, "%08x\n", (unsigned int) shownHash);
+    #endif
+
+    if (rowHashes) {
+        for (int row = 0; row < GDRAM_SIM_ROWS; row++) {
+            fprintf(rowHashes, "%08x%c", (unsigned int) gdramSimRowHash(row), (row == GDRAM_SIM_ROWS - 1) ? '\n' : ' ');
+        }
+    }
+
+    if (pixels) {
+        fwrite(gdramSim, sizeof(gdramSim), 1, pixels);
+    }
+
+    numFrames++;
+    framesPending--;
+}
+
+static void frameSent(void)
+{
+    if (framesPending) {
+        recordFrame();
+    }
+
+    #if (DISPLAY_BACKEND == DISPLAY_SSD1306)
+        else {
+            /* Not a frame, but the clearing of GDDRAM by devSSD1306init(). */
+            dataHash = FNV_OFFSET_BASIS;
+            dataSent = 0;
+        }
+    #endif
+}
+
+void FLUSH_WRAPPER(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS])
+{
+    /*
+        With asynchronous scanout, the flush first waits for the last to be sent, driving CS high. That ends the frame
+        pending, if any, and must not end this one, so it is done here before this frame is counted.
+    */
+    #if (DISPLAY_BACKEND == DISPLAY_SSD1331)
+        waitForFrame();
+    #endif
+
+    #if (FRAMELESS_RENDERING)
+        /* The frame has already been sent, so ends here. The flushes that follow it before the next send nothing. */
+        if ( (frame == NULL) && (spiMockCommandBytes + spiMockDataBytes != lastFrameBytes) ) {
+            lastFrameBytes = spiMockCommandBytes + spiMockDataBytes;
+            framesPending++;
+        }
+    #endif
+
+    /*
+        A frame that left GDRAM as it was, as with dirty rectangles and nothing drawn, sends nothing. The host display
+        sends nothing at all, so its frames all end here.
+    */
+    if (framesPending && !spiMockSelected()) {
+        recordFrame();
+    }
+
+    /* Taken after any frame that has been sent without a frame array, so that it too is not counted. */
+    if (!flushed) {
+        flushed = 1;
+        firstTransfers = spiMockTransfers;
+        firstCommandBytes = spiMockCommandBytes;
+        firstDataBytes = spiMockDataBytes;
+        firstFrames = numFrames;
+    }
+
+    #if (BANDED_RENDERING)
+        if ( (frame != NULL) && (band_first_row + BAND_NUM_ROWS == FRAME_NUM_ROWS) ) {
+            framesPending++;
+        }
+    #else
+        if (frame != NULL) {
+            framesPending++;
+        }
+    #endif
+
+    realFlush(frame);
+
+    #if (DISPLAY_BACKEND == DISPLAY_HOST)
+        checkImage(frame);
+    #endif
+}
+
+int main(int argc, char **argv)
+{
+    if ( (argc < 2) || (argc > 4) ) {
+        fprintf(stderr, "Usage: %s HASH_FILE [ROW_HASH_FILE [PIXEL_FILE]]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    hashes = fopen(argv[1], "w");
+
+    if (hashes == NULL) {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    if (argc >= 3) {
+        rowHashes = fopen(argv[2], "w");
+
+        if (rowHashes == NULL) {
+            perror(argv[2]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (argc == 4) {
+        pixels = fopen(argv[3], "wb");
+
+        if (pixels == NULL) {
+            perror(argv[3]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    #if (DISPLAY_BACKEND != DISPLAY_SSD1331)
+        if (rowHashes || pixels) {
+            fprintf(stderr, "Rows and pixels are those of the GDRAM of the SSD1331.\n");
+            return EXIT_FAILURE;
+        }
+    #endif
+
+    gdramSimReset();
+    spiMockDeselected = frameSent;
+
+    #if (DISPLAY_BACKEND == DISPLAY_SSD1306)
+        /* The bytes are those of the SSD1306, which gdram_sim.c would take for SSD1331 commands. */
+        spiMockCommands = NULL;
+        spiMockData = hashData;
+    #endif
+
+    #if (DISPLAY_VTABLE)
+        hookedDisplay = *display;
+        realFlush = hookedDisplay.flush;
+        hookedDisplay.flush = flushFrame;
+        display = &hookedDisplay;
+    #endif
+
+    graphicsDemo();
+
+    while (framesPending) {
+        recordFrame();
+    }
+
+    fclose(hashes);
+
+    if (rowHashes) {
+        fclose(rowHashes);
+    }
+
+    if (pixels) {
+        fclose(pixels);
+    }
+
+    printf("Frames sent: %u.\n", (unsigned int) numFrames);
+
+    #if (DISPLAY_BACKEND == DISPLAY_HOST)
+        printf("Host images: %u checked, %u differ from their frames.\n", (unsigned int) imagesChecked,
+            (unsigned int) imagesDifferent);
+    #endif
+
+    if (numFrames > firstFrames) {
+        printf("SPI per frame: %.1f transfers, %.1f command bytes, %.1f data bytes.\n",
+            (double) (spiMockTransfers - firstTransfers) / (numFrames - firstFrames),
+            (double) (spiMockCommandBytes - firstCommandBytes) / (numFrames - firstFrames),
+            (double) (spiMockDataBytes - firstDataBytes) / (numFrames - firstFrames));
+    }
+
+    #if (DISPLAY_BACKEND == DISPLAY_HOST)
+        if (imagesDifferent) {
+            return EXIT_FAILURE;
+        }
+    #endif
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,251 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "gdram_sim.h"
+
+/* SSD1331 commands, see devSSD1331.h. */
+#define COMMAND_DRAWLINE    0x21
+#define COMMAND_DRAWRECT    0x22
+#define COMMAND_CLEAR       0x25
+#define COMMAND_FILL        0x26
+#define COMMAND_SETCOLUMN   0x15
+#define COMMAND_SETROW      0x75
+
+/* Filled into GDRAM by gdramSimReset(). Its LSB is not that of any pixel value, so it shows pixels never written. */
+#define GDRAM_SIM_UNWRITTEN 0xA5A5
+
+uint16_t gdramSim[GDRAM_SIM_ROWS][GDRAM_SIM_COLS];
+
+/* The write area and the GDRAM pointers within it. */
+static uint8_t firstCol;
+static uint8_t lastCol;
+static uint8_t firstRow;
+static uint8_t lastRow;
+static uint8_t col;
+static uint8_t row;
+
+/* The first (most significant) byte of a pixel whose second byte has not yet been received. */
+static uint8_t pixelMsb;
+static uint8_t havePixelMsb;
+
+/* The command being received and the number of its argument bytes still to come. */
+static uint8_t command[16];
+static uint8_t commandBytes;
+static uint8_t argumentsNeeded;
+
+static uint8_t fillEnabled;
+
+/* Number of argument bytes taken by each command. */
+static uint8_t numArguments(uint8_t command_byte)
+{
+    switch (command_byte) {
+        case COMMAND_SETCOLUMN:
+        case COMMAND_SETROW:
+            return 2;
+
+        case COMMAND_CLEAR:
+            return 4;
+
+        case COMMAND_DRAWLINE:
+            return 7;
+
+        case COMMAND_DRAWRECT:
+            return 10;
+
+        /* FILL, SETREMAP, STARTLINE, DISPLAYOFFSET, SETMULTIPLEX, SETMASTER, POWERMODE, PRECHARGE, CLOCKDIV,
+           PRECHARGEA/B/C, PRECHARGELEVEL, VCOMH, MASTERCURRENT and CONTRASTA/B/C. */
+        case COMMAND_FILL: case 0xA0: case 0xA1: case 0xA2: case 0xA8: case 0xAD: case 0xB0: case 0xB1: case 0xB3:
+        case 0x8A: case 0x8B: case 0x8C: case 0xBB: case 0xBE: case 0x87: case 0x81: case 0x82: case 0x83:
+            return 1;
+
+        default:
+            return 0;
+    }
+}
+
+/* Converts the three 6 bit colour arguments of DRAWLINE and DRAWRECT, C then B then A, into a GDRAM colour. */
+static uint16_t drawColour(const uint8_t colour[3])
+{
+    return ( ((colour[0] & 0x3E) >> 1) << 11 ) | ( (colour[1] & 0x3F) << 5 ) | ( (colour[2] & 0x3E) >> 1 );
+}
+
+static void setPixel(int pixel_row, int pixel_col, uint16_t colour)
+{
+    if ( (pixel_row < 0) || (pixel_row >= GDRAM_SIM_ROWS) || (pixel_col < 0) || (pixel_col >= GDRAM_SIM_COLS) ) {
+        fprintf(stderr, "gdram_sim: pixel (%d, %d) drawn off the display.\n", pixel_col, pixel_row);
+        abort();
+    }
+
+    gdramSim[pixel_row][pixel_col] = colour;
+}
+
+static void drawLine(int x0, int y0, int x1, int y1, uint16_t colour)
+{
+    int dx = abs(x1 - x0);
+    int dy = -abs(y1 - y0);
+    int step_x = (x0 < x1) ? 1 : -1;
+    int step_y = (y0 < y1) ? 1 : -1;
+    int err = dx + dy;
+    int err2;
+
+    for (;;) {
+        setPixel(y0, x0, colour);
+
+        if ( (x0 == x1) && (y0 == y1) ) {
+            break;
+        }
+
+        /* Both steps are decided on the error before either is taken. */
+        err2 = 2 * err;
+
+        if (err2 >= dy) {
+            err += dy;
+            x0 += step_x;
+        }
+
+        if (err2 <= dx) {
+            err += dx;
+            y0 += step_y;
+        }
+    }
+}
+
+static void executeCommand(void)
+{
+    const uint8_t *args = &command[1];
+
+    switch (command[0]) {
+        case COMMAND_SETCOLUMN:
+            firstCol = args[0];
+            lastCol = args[1];
+            col = firstCol;
+            havePixelMsb = 0;
+            break;
+
+        case COMMAND_SETROW:
+            firstRow = args[0];
+            lastRow = args[1];
+            row = firstRow;
+            havePixelMsb = 0;
+            break;
+
+        case COMMAND_FILL:
+            fillEnabled = args[0] & 1;
+            break;
+
+        case COMMAND_CLEAR:
+            for (int r = args[1]; r <= args[3]; r++) {
+                for (int c = args[0]; c <= args[2]; c++) {
+                    setPixel(r, c, 0);
+                }
+            }
+            break;
+
+        case COMMAND_DRAWRECT:
+            for (int r = args[1]; r <= args[3]; r++) {
+                for (int c = args[0]; c <= args[2]; c++) {
+                    if ( (r == args[1]) || (r == args[3]) || (c == args[0]) || (c == args[2]) ) {
+                        setPixel(r, c, drawColour(&args[4]));
+                    } else if (fillEnabled) {
+                        setPixel(r, c, drawColour(&args[7]));
+                    }
+                }
+            }
+            break;
+
+        case COMMAND_DRAWLINE:
+            drawLine(args[0], args[1], args[2], args[3], drawColour(&args[4]));
+            break;
+
+        default:
+            break;
+    }
+}
+
+void gdramSimReset(void)
+{
+    for (int r = 0; r < GDRAM_SIM_ROWS; r++) {
+        for (int c = 0; c < GDRAM_SIM_COLS; c++) {
+            gdramSim[r][c] = GDRAM_SIM_UNWRITTEN;
+        }
+    }
+
+    firstCol = 0;
+    lastCol = GDRAM_SIM_COLS - 1;
+    firstRow = 0;
+    lastRow = GDRAM_SIM_ROWS - 1;
+    col = 0;
+    row = 0;
+    havePixelMsb = 0;
+    commandBytes = 0;
+    fillEnabled = 0;
+}
+
+void gdramSimCommands(const uint8_t *bytes, size_t num_bytes)
+{
+    for (size_t i = 0; i < num_bytes; i++) {
+        if (commandBytes == 0) {
+            argumentsNeeded = numArguments(bytes[i]);
+        } else {
+            argumentsNeeded--;
+        }
+
+        command[commandBytes++] = bytes[i];
+
+        if (argumentsNeeded == 0) {
+            executeCommand();
+            commandBytes = 0;
+        }
+    }
+}
+
+void gdramSimData(const uint8_t *bytes, size_t num_bytes)
+{
+    if (commandBytes) {
+        fprintf(stderr, "gdram_sim: data sent before the arguments of command 0x%02X.\n", command[0]);
+        abort();
+    }
+
+    for (size_t i = 0; i < num_bytes; i++) {
+        if (!havePixelMsb) {
+            pixelMsb = bytes[i];
+            havePixelMsb = 1;
+            continue;
+        }
+
+        setPixel(row, col, (pixelMsb << 8) | bytes[i]);
+        havePixelMsb = 0;
+
+        /* The column pointer wraps to the next row, and the row pointer to the top of the write area. */
+        if (++col > lastCol) {
+            col = firstCol;
+
+            if (++row > lastRow) {
+                row = firstRow;
+            }
+        }
+    }
+}
+
+static uint32_t hashRows(uint32_t hash, int first_row, int last_row)
+{
+    for (int r = first_row; r <= last_row; r++) {
+        for (int c = 0; c < GDRAM_SIM_COLS; c++) {
+            hash = (hash ^ (gdramSim[r][c] >> 8)) * 16777619u;
+            hash = (hash ^ (gdramSim[r][c] & 0xFF)) * 16777619u;
+        }
+    }
+
+    return hash;
+}
+
+uint32_t gdramSimHash(void)
+{
+    return hashRows(2166136261u, 0, GDRAM_SIM_ROWS - 1);
+}
+
+uint32_t gdramSimRowHash(int row)
+{
+    return hashRows(2166136261u, row, row);
+}
@@ -0,0 +1,23 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#define GDRAM_SIM_ROWS 64
+#define GDRAM_SIM_COLS 96
+
+/*
+    A simulated SSD1331, fed with the bytes sent to it by spi_mock.c.
+
+    Command bytes are parsed into commands and their arguments. SETCOLUMN and SETROW set the write area, DRAWLINE,
+    DRAWRECT (with FILL) and CLEAR draw into GDRAM as the SSD1331 does, and the other commands are ignored. Data bytes
+    are written into the write area two to a pixel, MSB first, with the column and row pointers wrapping as the
+    SSD1331's do. GDRAM starts out filled with a pattern no pixel value converts to.
+*/
+extern uint16_t gdramSim[GDRAM_SIM_ROWS][GDRAM_SIM_COLS];
+
+void gdramSimReset(void);
+void gdramSimCommands(const uint8_t *bytes, size_t num_bytes);
+void gdramSimData(const uint8_t *bytes, size_t num_bytes);
+
+/* Returns an FNV-1a hash of GDRAM, or of one row of it. */
+uint32_t gdramSimHash(void);
+uint32_t gdramSimRowHash(int row);
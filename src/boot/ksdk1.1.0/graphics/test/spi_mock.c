@@ -0,0 +1,306 @@
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fsl_spi_master_driver.h"
+#include "fsl_port_hal.h"
+#include "fsl_clock_manager.h"
+#include "gpio_pins.h"
+#include "warp.h"
+
+#include "spi_mock.h"
+#include "gdram_sim.h"
+
+/* Pins of the SSD1331, as in devSSD1331.c. */
+#define PIN_CS GPIO_MAKE_PIN(HW_GPIOB, 11)
+#define PIN_DC GPIO_MAKE_PIN(HW_GPIOA, 12)
+
+void (*spiMockCommands)(const uint8_t *bytes, size_t num_bytes) = gdramSimCommands;
+void (*spiMockData)(const uint8_t *bytes, size_t num_bytes) = gdramSimData;
+void (*spiMockDeselected)(void) = NULL;
+
+uint32_t spiMockTransfers = 0;
+uint32_t spiMockCommandBytes = 0;
+uint32_t spiMockDataBytes = 0;
+
+/*
+    An asynchronous transfer completes, as if the SPI interrupt had sent its last byte, on this poll of
+    SPI_DRV_MasterGetTransferStatus(). Until then the CPU may run on, and the buffer must be left as it was.
+*/
+#define POLLS_TO_COMPLETE 3
+
+/* Larger than any staging buffer, 36 rows of 96 columns at 2 bytes each. */
+#define MAX_ASYNC_BYTES 8192
+
+/*
+    Simulated time, in core cycles at CORE_HZ. A byte takes BYTE_CYCLES to shift out, as at an SCK of 10 MHz. A KSDK
+    blocking transfer is assumed to take KSDK_TRANSFER_CYCLES to set up and KSDK_BYTE_CYCLES per byte for its
+    interrupt handler, estimates rather than measurements, such that printSpiBenchmark() has something to compare.
+    A register access takes the cycles of a load or store to the peripheral bus and the instructions around it.
+*/
+#define CORE_HZ 48000000
+#define BYTE_CYCLES 38.4
+#define KSDK_TRANSFER_CYCLES 2000
+#define KSDK_BYTE_CYCLES 150
+#define REGISTER_READ_CYCLES 3
+#define REGISTER_WRITE_CYCLES 2
+
+static uint8_t csLow = 0;
+static uint8_t dcHigh = 0;
+static uint32_t delayMilliseconds = 0;
+
+/* The asynchronous transfer in progress, if busy, and a copy of its buffer as it was started. */
+static uint8_t busy = 0;
+static uint8_t polls;
+static const uint8_t *asyncBuffer;
+static size_t asyncByteCount;
+static uint8_t asyncSnapshot[MAX_ASYNC_BYTES];
+
+static double cycles = 0;
+
+/*
+    The SPI0 registers as written by REGISTER_LEVEL_SPI. A byte written to D waits in the transmit buffer (SPTEF
+    clear) until the shifter is free, then takes BYTE_CYCLES to shift out, after which the byte received is in D
+    (SPRF set) until read.
+*/
+static uint8_t transmitFull = 0;
+static uint8_t transmitByte;
+static double transmitWritten;
+static uint8_t shifting = 0;
+static uint8_t shiftByte;
+static double shiftEnd;
+static uint8_t receiveFull = 0;
+static uint8_t emptySeen = 0;   /* S has been read with SPTEF set since D was last written. */
+
+static void fail(const char *message)
+{
+    fprintf(stderr, "spi_mock: %s\n", message);
+    abort();
+}
+
+/* The bytes reach the display. */
+static void sendBytes(const uint8_t *bytes, size_t num_bytes)
+{
+    if (!csLow) {
+        fail("bytes sent with CS high.");
+    }
+
+    if (dcHigh) {
+        spiMockDataBytes += num_bytes;
+
+        if (spiMockData) {
+            spiMockData(bytes, num_bytes);
+        }
+    } else {
+        spiMockCommandBytes += num_bytes;
+
+        if (spiMockCommands) {
+            spiMockCommands(bytes, num_bytes);
+        }
+    }
+}
+
+uint8_t spiMockSelected(void)
+{
+    return csLow;
+}
+
+/* Moves the shifter of SPI0 on to the current time. */
+static void shiftBytes(void)
+{
+    for (;;) {
+        if (!shifting && transmitFull) {
+            shifting = 1;
+            shiftByte = transmitByte;
+            transmitFull = 0;
+            /* The byte starts once both it has been written and the byte before has been shifted out. */
+            shiftEnd = ( (shiftEnd > transmitWritten) ? shiftEnd : transmitWritten ) + BYTE_CYCLES;
+        }
+
+        if (!shifting || (cycles < shiftEnd)) {
+            return;
+        }
+
+        if (receiveFull) {
+            fail("SPI0 receive overrun, the byte received before was not read.");
+        }
+
+        sendBytes(&shiftByte, 1);
+        shifting = 0;
+        receiveFull = 1;
+    }
+}
+
+uint8_t spiMockReadS(void)
+{
+    cycles += REGISTER_READ_CYCLES;
+    shiftBytes();
+
+    emptySeen = !transmitFull;
+
+    return (transmitFull ? 0 : BM_SPI_S_SPTEF) | (receiveFull ? BM_SPI_S_SPRF : 0);
+}
+
+void spiMockWriteD(uint8_t value)
+{
+    cycles += REGISTER_WRITE_CYCLES;
+    shiftBytes();
+
+    if (!emptySeen || transmitFull) {
+        fail("SPI0 D written without first reading S with SPTEF set, so the byte is lost.");
+    }
+
+    emptySeen = 0;
+    transmitFull = 1;
+    transmitByte = value;
+    transmitWritten = cycles;
+    shiftBytes();
+}
+
+uint8_t spiMockReadD(void)
+{
+    cycles += REGISTER_READ_CYCLES;
+    shiftBytes();
+
+    receiveFull = 0;
+
+    return 0;
+}
+
+spi_status_t SPI_DRV_MasterTransferBlocking(uint32_t instance, const spi_master_user_config_t *device,
+    const uint8_t *sendBuffer, uint8_t *receiveBuffer, size_t transferByteCount, uint32_t timeout)
+{
+    if (busy) {
+        fail("blocking transfer while an asynchronous one is in progress.");
+    }
+
+    if (transmitFull || shifting) {
+        fail("blocking transfer while SPI0 is still shifting out a byte.");
+    }
+
+    spiMockTransfers++;
+    cycles += KSDK_TRANSFER_CYCLES + KSDK_BYTE_CYCLES * transferByteCount;
+    sendBytes(sendBuffer, transferByteCount);
+
+    return kStatus_SPI_Success;
+}
+
+spi_status_t SPI_DRV_MasterTransfer(uint32_t instance, const spi_master_user_config_t *device,
+    const uint8_t *sendBuffer, uint8_t *receiveBuffer, size_t transferByteCount)
+{
+    if (busy) {
+        fail("asynchronous transfer started while the last is in progress.");
+    }
+
+    if (!csLow) {
+        fail("asynchronous transfer started with CS high.");
+    }
+
+    if (transferByteCount > MAX_ASYNC_BYTES) {
+        fail("asynchronous transfer larger than MAX_ASYNC_BYTES.");
+    }
+
+    spiMockTransfers++;
+    busy = 1;
+    polls = 0;
+    asyncBuffer = sendBuffer;
+    asyncByteCount = transferByteCount;
+    memcpy(asyncSnapshot, sendBuffer, transferByteCount);
+
+    return kStatus_SPI_Success;
+}
+
+spi_status_t SPI_DRV_MasterGetTransferStatus(uint32_t instance, uint32_t *framesTransferred)
+{
+    if (!busy) {
+        return kStatus_SPI_Success;
+    }
+
+    if (++polls < POLLS_TO_COMPLETE) {
+        return kStatus_SPI_Busy;
+    }
+
+    /* The interrupt has sent the whole buffer, which must not have been touched while it did. */
+    if (memcmp(asyncBuffer, asyncSnapshot, asyncByteCount) != 0) {
+        fail("buffer of an asynchronous transfer changed before it completed.");
+    }
+
+    busy = 0;
+    sendBytes(asyncSnapshot, asyncByteCount);
+
+    return kStatus_SPI_Success;
+}
+
+/* CS and DC must not change until the bytes sent before have all been. */
+static void checkPinChange(uint32_t pin)
+{
+    if ( busy && ((pin == PIN_CS) || (pin == PIN_DC)) ) {
+        fail("CS or DC changed while an asynchronous transfer is in progress.");
+    }
+
+    if ( (transmitFull || shifting) && ((pin == PIN_CS) || (pin == PIN_DC)) ) {
+        fail("CS or DC changed while SPI0 is still shifting out a byte.");
+    }
+}
+
+void GPIO_DRV_SetPinOutput(uint32_t pin)
+{
+    checkPinChange(pin);
+
+    if (pin == PIN_CS) {
+        if (csLow) {
+            csLow = 0;
+
+            if (spiMockDeselected) {
+                spiMockDeselected();
+            }
+        }
+    } else if (pin == PIN_DC) {
+        dcHigh = 1;
+    }
+}
+
+void GPIO_DRV_ClearPinOutput(uint32_t pin)
+{
+    checkPinChange(pin);
+
+    if (pin == PIN_CS) {
+        csLow = 1;
+    } else if (pin == PIN_DC) {
+        dcHigh = 0;
+    }
+}
+
+void PORT_HAL_SetMuxMode(uint32_t baseAddr, uint32_t pin, port_mux_t mux)
+{
+}
+
+uint32_t CLOCK_SYS_GetCoreClockFreq(void)
+{
+    return CORE_HZ;
+}
+
+void warpEnableSPIpins(void)
+{
+}
+
+void warpPrint(const char *fmt, ...)
+{
+    va_list args;
+
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+}
+
+uint32_t OSA_TimeGetMsec(void)
+{
+    return delayMilliseconds + (uint32_t) (cycles / (CORE_HZ / 1000));
+}
+
+void OSA_TimeDelay(uint32_t delay)
+{
+    delayMilliseconds += delay;
+}
@@ -0,0 +1,42 @@
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+    Host mock of the KSDK SPI master driver, GPIO driver and OSA timing used by the display drivers, with the SSD1331
+    on the other end of the bus simulated by gdram_sim.c.
+
+    Bytes sent with DC low are fed to spiMockCommands and with DC high to spiMockData, gdramSimCommands() and
+    gdramSimData() unless changed. The mock aborts the
+    test on misuse of the bus that real hardware would not report, such as a transfer with CS high.
+
+    SPI_DRV_MasterTransfer() is asynchronous, as with the SPI interrupt: the bytes are only sent when a later poll of
+    SPI_DRV_MasterGetTransferStatus() finds the transfer complete. The test is aborted if, before then, the buffer is
+    changed, another transfer is started, or CS or DC is changed, so the ping-pong buffers of ASYNC_SCANOUT must be
+    swapped and waited for in order.
+
+    The SPI0 registers written by REGISTER_LEVEL_SPI (see stubs/fsl_spi_master_driver.h) are modelled too, byte by
+    byte, with the test aborted if D is written without SPTEF having been read set, a received byte is overrun, or CS
+    or DC is changed before the last byte has been shifted out.
+
+    OSA_TimeGetMsec() returns the milliseconds waited in OSA_TimeDelay() and those of the simulated SPI, the bytes
+    shifted out and the assumed cost of the KSDK driver, so the timings printed are of the display and bus alone.
+    warpPrint() writes to stdout.
+*/
+
+/* Non zero while CS is driven low. */
+uint8_t spiMockSelected(void);
+
+/* Fed with the bytes sent with DC low and high, if set. */
+extern void (*spiMockCommands)(const uint8_t *bytes, size_t num_bytes);
+extern void (*spiMockData)(const uint8_t *bytes, size_t num_bytes);
+
+/* If set, called whenever CS is driven high after having been low, that is, at the end of each transaction. */
+extern void (*spiMockDeselected)(void);
+
+/*
+    KSDK SPI transfers started, and the bytes sent with DC low (commands) and high (data) by them and through the
+    SPI0 registers, since the start.
+*/
+extern uint32_t spiMockTransfers;
+extern uint32_t spiMockCommandBytes;
+extern uint32_t spiMockDataBytes;
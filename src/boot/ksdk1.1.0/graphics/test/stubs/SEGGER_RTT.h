@@ -0,0 +1,3 @@
+/*
+    Host stand-in for SEGGER_RTT.h. Output goes through warpPrint(), see spi_mock.c.
+*/
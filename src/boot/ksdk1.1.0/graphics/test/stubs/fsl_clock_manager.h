@@ -0,0 +1,6 @@
+/*
+    Host stand-in for the KSDK clock manager. The core clock is that of the simulated SPI bus, see spi_mock.c.
+*/
+#include <stdint.h>
+
+uint32_t CLOCK_SYS_GetCoreClockFreq(void);
@@ -0,0 +1,14 @@
+/*
+    Host stand-in for the KSDK port HAL. The pin multiplexing is not modelled.
+*/
+#include <stdint.h>
+
+typedef enum {
+    kPortMuxAsGpio = 1,
+    kPortMuxAlt3 = 3
+} port_mux_t;
+
+#define PORTA_BASE 0
+#define PORTB_BASE 1
+
+void PORT_HAL_SetMuxMode(uint32_t baseAddr, uint32_t pin, port_mux_t mux);
@@ -0,0 +1,31 @@
+/*
+    Host stand-in for the KSDK SPI master driver, declaring only what the graphics sources use, and for the SPI0
+    register access macros of the KL03 headers that come with it. The definitions are in spi_mock.c.
+*/
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum {
+    kStatus_SPI_Success = 0,
+    kStatus_SPI_Busy = 3
+} spi_status_t;
+
+typedef struct SpiMasterUserConfig spi_master_user_config_t;
+
+spi_status_t SPI_DRV_MasterTransferBlocking(uint32_t instance, const spi_master_user_config_t *device,
+    const uint8_t *sendBuffer, uint8_t *receiveBuffer, size_t transferByteCount, uint32_t timeout);
+spi_status_t SPI_DRV_MasterTransfer(uint32_t instance, const spi_master_user_config_t *device,
+    const uint8_t *sendBuffer, uint8_t *receiveBuffer, size_t transferByteCount);
+spi_status_t SPI_DRV_MasterGetTransferStatus(uint32_t instance, uint32_t *framesTransferred);
+
+#define SPI0_BASE 0
+#define BM_SPI_S_SPTEF (0x20U)
+#define BM_SPI_S_SPRF (0x80U)
+
+uint8_t spiMockReadS(void);
+void spiMockWriteD(uint8_t value);
+uint8_t spiMockReadD(void);
+
+#define HW_SPI_S_RD(base) spiMockReadS()
+#define HW_SPI_D_WR(base, value) spiMockWriteD(value)
+#define HW_SPI_D_RD(base) spiMockReadD()
@@ -0,0 +1,14 @@
+/*
+    Host stand-in for gpio_pins.h and the KSDK GPIO driver. The definitions are in spi_mock.c.
+*/
+#include <stdint.h>
+
+#define GPIO_MAKE_PIN(port, pin) ( ((port) << 8) | (pin) )
+
+enum {
+    HW_GPIOA = 0,
+    HW_GPIOB = 1
+};
+
+void GPIO_DRV_SetPinOutput(uint32_t pin);
+void GPIO_DRV_ClearPinOutput(uint32_t pin);
@@ -0,0 +1,9 @@
+/*
+    Host stand-in for warp.h, declaring only what the graphics sources use. The definitions are in spi_mock.c.
+*/
+#include <stdint.h>
+
+void warpPrint(const char *fmt, ...);
+void warpEnableSPIpins(void);
+uint32_t OSA_TimeGetMsec(void);
+void OSA_TimeDelay(uint32_t delay);
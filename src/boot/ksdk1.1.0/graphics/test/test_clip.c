@@ -0,0 +1,367 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "clip.h"
+
+/*
+    Checks clip_triangle(), with SCREEN_CLIPPING and without the guard band rasteriser.
+
+    A few triangles are checked against the polygons they must give: wholly inside the frame, unchanged; wholly
+    beyond one edge, or passing beyond a corner without covering it, rejected; covering a corner, or the whole frame,
+    clipped to the polygon of the frame they cover, in the same winding.
+
+    Random triangles from about the frame to the whole guard band are then checked for what any clip must give. Each
+    vertex lies on or inside the frame and, to within the rounding, inside the triangle. The polygon keeps the
+    winding of the triangle and covers every pixel centre of the frame that lies more than a pixel inside the
+    triangle, and a rejected triangle covers none.
+
+    Last, random pairs of triangles sharing an edge, taken in opposite directions as by neighbours in a mesh, must
+    find the same vertices where that edge crosses the edges of the frame.
+*/
+
+#define MAX_X ( (FRAME_NUM_COLS - 1) << SUBPIXEL_BITS )
+#define MAX_Y ( (FRAME_NUM_ROWS - 1) << SUBPIXEL_BITS )
+
+#define NUM_RANDOM 20000
+
+/* How far, in 1/2^SUBPIXEL_BITS pixels, rounding may move a vertex found by clipping off an edge of the triangle. */
+#define TOLERANCE 1.0
+
+static uint32_t num_failures = 0;
+
+static void fail(const char *what, const ScreenCoord vs[3][2])
+{
+    if (num_failures++ < 10) {
+        printf("Triangle (%d, %d), (%d, %d), (%d, %d): %s.\n", vs[0][X], vs[0][Y], vs[1][X], vs[1][Y], vs[2][X],
+            vs[2][Y], what);
+    }
+}
+
+/* Returns twice the signed area of the triangle p, q, r, positive if anticlockwise with y up. */
+static double area2(double px, double py, double qx, double qy, double rx, double ry)
+{
+    return ((qx - px) * (ry - py)) - ((qy - py) * (rx - px));
+}
+
+/* Returns the distance of (x, y) inside the edge p to q of a polygon with the given winding, negative if outside. */
+static double insideDistance(double px, double py, double qx, double qy, double x, double y, double winding)
+{
+    double length = sqrt(((qx - px) * (qx - px)) + ((qy - py) * (qy - py)));
+
+    return (length == 0) ? INFINITY : winding * area2(px, py, qx, qy, x, y) / length;
+}
+
+/* Returns the least distance of (x, y) inside the edges of the triangle vs. */
+static double insideTriangle(const ScreenCoord vs[3][2], double winding, double x, double y)
+{
+    double least = INFINITY;
+    double distance;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        distance = insideDistance(vs[i][X], vs[i][Y], vs[(i + 1) % 3][X], vs[(i + 1) % 3][Y], x, y, winding);
+        least = (distance < least) ? distance : least;
+    }
+
+    return least;
+}
+
+/* Returns the least distance of (x, y) inside the edges of the convex polygon of n vertices. */
+static double insidePolygon(const VertexCoord polygon[CLIP_MAX_VERTICES][2], uint8_t n, double winding, double x, double y)
+{
+    double least = INFINITY;
+    double distance;
+
+    for (uint8_t i = 0; i < n; i++) {
+        distance = insideDistance(polygon[i][X], polygon[i][Y], polygon[(i + 1) % n][X], polygon[(i + 1) % n][Y], x, y,
+            winding);
+        least = (distance < least) ? distance : least;
+    }
+
+    return least;
+}
+
+/* Returns whether the polygon of n vertices is expected, of num_expected, from any vertex on. */
+static uint8_t samePolygon(const VertexCoord polygon[CLIP_MAX_VERTICES][2], uint8_t n, const int expected[][2], uint8_t num_expected)
+{
+    if (n != num_expected) {
+        return 0;
+    }
+
+    if (n == 0) {
+        return 1;
+    }
+
+    for (uint8_t start = 0; start < n; start++) {
+        uint8_t i = 0;
+
+        while ( (i < n) && (polygon[(start + i) % n][X] == expected[i][X]) && (polygon[(start + i) % n][Y] == expected[i][Y]) ) {
+            i++;
+        }
+
+        if (i == n) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void checkExpected(int v0x, int v0y, int v1x, int v1y, int v2x, int v2y, const int expected[][2], uint8_t num_expected)
+{
+    ScreenCoord vs[3][2] = { { v0x, v0y }, { v1x, v1y }, { v2x, v2y } };
+    VertexCoord polygon[CLIP_MAX_VERTICES][2];
+    uint8_t n = clip_triangle(vs, polygon);
+
+    if (!samePolygon(polygon, n, expected, num_expected)) {
+        fail("not clipped to the expected polygon", vs);
+    }
+}
+
+/* Checks the clip of the triangle vs for what any clip must give. Returns the number of vertices. */
+static uint8_t checkRandom(const ScreenCoord vs[3][2], VertexCoord polygon[CLIP_MAX_VERTICES][2])
+{
+    uint8_t n = clip_triangle(vs, polygon);
+    double area = area2(vs[0][X], vs[0][Y], vs[1][X], vs[1][Y], vs[2][X], vs[2][Y]);
+    double winding = (area > 0) ? 1 : -1;
+    uint8_t inside = 1;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        inside = inside && (vs[i][X] >= 0) && (vs[i][X] <= MAX_X) && (vs[i][Y] >= 0) && (vs[i][Y] <= MAX_Y);
+    }
+
+    if (inside) {
+        for (uint8_t i = 0; i < 3; i++) {
+            if ( (n != 3) || (polygon[i][X] != vs[i][X]) || (polygon[i][Y] != vs[i][Y]) ) {
+                fail("wholly inside the frame but changed", vs);
+                return n;
+            }
+        }
+    }
+
+    if ( (n != 0) && ((n < 3) || (n > CLIP_MAX_VERTICES)) ) {
+        fail("clipped to a polygon of too few or too many vertices", vs);
+        return n;
+    }
+
+    for (uint8_t i = 0; i < n; i++) {
+        if ( (polygon[i][X] > MAX_X) || (polygon[i][Y] > MAX_Y) ) {
+            fail("clipped to a vertex off the frame", vs);
+            return n;
+        }
+
+        if ( (area != 0) && (insideTriangle(vs, winding, polygon[i][X], polygon[i][Y]) < -TOLERANCE) ) {
+            fail("clipped to a vertex outside the triangle", vs);
+            return n;
+        }
+    }
+
+    if ( (n != 0) && (area != 0) ) {
+        double polygon_area = 0;
+
+        for (uint8_t i = 1; i + 1 < n; i++) {
+            polygon_area += area2(polygon[0][X], polygon[0][Y], polygon[i][X], polygon[i][Y], polygon[i + 1][X],
+                polygon[i + 1][Y]);
+        }
+
+        /* Slivers may be turned over by rounding, by up to about the perimeter of the frame. */
+        if (polygon_area * winding < -2 * (MAX_X + MAX_Y) * TOLERANCE) {
+            fail("clipped to a polygon of the opposite winding", vs);
+            return n;
+        }
+    }
+
+    if (area == 0) {
+        return n;
+    }
+
+    /* Pixel centres well inside the triangle must be inside the polygon, to within the rounding of its vertices. */
+    for (int32_t y = 0; y <= MAX_Y; y += (1 << SUBPIXEL_BITS)) {
+        for (int32_t x = 0; x <= MAX_X; x += (1 << SUBPIXEL_BITS)) {
+            if (insideTriangle(vs, winding, x, y) <= (1 << SUBPIXEL_BITS)) {
+                continue;
+            }
+
+            if (n == 0) {
+                fail("rejected but covers the frame", vs);
+                return n;
+            }
+
+            if (insidePolygon(polygon, n, winding, x, y) < -TOLERANCE) {
+                fail("clipped to a polygon that misses part of the frame it covers", vs);
+                return n;
+            }
+        }
+    }
+
+    return n;
+}
+
+/* Returns a random coordinate within spread of centre, and within the guard band. */
+static ScreenCoord randomCoord(int32_t centre, int32_t spread)
+{
+    int32_t coord = centre - spread + (rand() % (2 * spread + 1));
+
+    return (ScreenCoord) ( (coord < -GUARD_BAND_LIMIT) ? -GUARD_BAND_LIMIT : ((coord > GUARD_BAND_LIMIT) ? GUARD_BAND_LIMIT : coord) );
+}
+
+/* Returns whether the coordinate lies within 3 pixels of either edge of the frame across its axis, max being the far one. */
+static uint8_t nearEdge(ScreenCoord coord, int32_t max)
+{
+    return (abs(coord) < (3 << SUBPIXEL_BITS)) || (abs(coord - max) < (3 << SUBPIXEL_BITS));
+}
+
+/*
+    Collects the vertices of the polygon of n vertices that lie on an edge of the frame, other than at its corners,
+    and within the rounding of the line through a and b: where the edge a to b crosses the edges of the frame.
+*/
+static uint8_t crossings(const VertexCoord polygon[CLIP_MAX_VERTICES][2], uint8_t n, const ScreenCoord a[2],
+    const ScreenCoord b[2], VertexCoord found[CLIP_MAX_VERTICES][2])
+{
+    uint8_t num_found = 0;
+    uint8_t on_x;
+    uint8_t on_y;
+
+    for (uint8_t i = 0; i < n; i++) {
+        on_x = (polygon[i][X] == 0) || (polygon[i][X] == MAX_X);
+        on_y = (polygon[i][Y] == 0) || (polygon[i][Y] == MAX_Y);
+
+        if ( (on_x != on_y) && (fabs(insideDistance(a[X], a[Y], b[X], b[Y], polygon[i][X], polygon[i][Y], 1)) <= TOLERANCE) ) {
+            COPY_2D_VERTEX(found[num_found], polygon[i]);
+            num_found++;
+        }
+    }
+
+    return num_found;
+}
+
+/* Returns whether every vertex of found_a is one of found_b. */
+static uint8_t allFound(const VertexCoord found_a[CLIP_MAX_VERTICES][2], uint8_t num_a, const VertexCoord found_b[CLIP_MAX_VERTICES][2], uint8_t num_b)
+{
+    for (uint8_t i = 0; i < num_a; i++) {
+        uint8_t found = 0;
+
+        for (uint8_t j = 0; j < num_b; j++) {
+            found = found || ( (found_a[i][X] == found_b[j][X]) && (found_a[i][Y] == found_b[j][Y]) );
+        }
+
+        if (!found) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+int main(void)
+{
+    /* The polygons that the triangles below must be clipped to, from any vertex, in the winding of the triangle. */
+    static const int corner[][2] = { { 0, 20 << SUBPIXEL_BITS }, { 20 << SUBPIXEL_BITS, 0 }, { 0, 0 } };
+    static const int frame[][2] = { { 0, 0 }, { MAX_X, 0 }, { MAX_X, MAX_Y }, { 0, MAX_Y } };
+    static const int cut_corner[][2] = { { 0, 0 }, { MAX_X, 0 }, { MAX_X, MAX_Y - (10 << SUBPIXEL_BITS) },
+        { MAX_X - (10 << SUBPIXEL_BITS), MAX_Y }, { 0, MAX_Y } };
+    static const int inside[][2] = { { 3, 4 }, { 30, 10 }, { 12, 33 } };
+
+    ScreenCoord vs[3][2];
+    ScreenCoord shared[2][3][2];
+    VertexCoord polygon[CLIP_MAX_VERTICES][2];
+    VertexCoord polygon_b[CLIP_MAX_VERTICES][2];
+    VertexCoord found[2][CLIP_MAX_VERTICES][2];
+    uint8_t num_found[2];
+    uint8_t n;
+    int32_t spread;
+    int32_t centre[2];
+    uint32_t num_clipped = 0;
+    uint32_t num_rejected = 0;
+    uint32_t num_shared = 0;
+    double dx;
+    double dy;
+    double t;
+    double h;
+
+    /* Wholly inside, unchanged. */
+    checkExpected(3, 4, 30, 10, 12, 33, inside, 3);
+
+    /* Wholly beyond the right edge, and beyond the bottom left and top right corners without covering them. */
+    checkExpected(MAX_X + 5, 0, MAX_X + 15, 10, MAX_X + 10, -5, NULL, 0);
+    checkExpected(-10, 5, 5, -10, -10, -10, NULL, 0);
+    checkExpected(MAX_X - 5, MAX_Y + 15, MAX_X + 15, MAX_Y - 5, MAX_X + 15, MAX_Y + 15, NULL, 0);
+
+    /* Covering the bottom left corner, clockwise. */
+    checkExpected(-(10 << SUBPIXEL_BITS), 30 << SUBPIXEL_BITS, 30 << SUBPIXEL_BITS, -(10 << SUBPIXEL_BITS),
+        -(10 << SUBPIXEL_BITS), -(10 << SUBPIXEL_BITS), corner, 3);
+
+    /* Covering the whole frame, and all of it but the top right corner. */
+    checkExpected(-100, -100, MAX_X + 200, -100, -100, MAX_Y + 200, frame, 4);
+    checkExpected(-100, -100, MAX_X + 100 + (25 << SUBPIXEL_BITS), -100, -100, MAX_Y + 100 + (25 << SUBPIXEL_BITS),
+        cut_corner, 5);
+
+    srand(1);
+
+    for (uint32_t i = 0; i < NUM_RANDOM; i++) {
+        /* A quarter of the triangles spread over the guard band, the rest over a few frames about it. */
+        spread = (i % 4) ? ((1 + rand() % 3) * MAX_X) : GUARD_BAND_LIMIT;
+        centre[X] = rand() % (MAX_X + 1);
+        centre[Y] = rand() % (MAX_Y + 1);
+
+        for (uint8_t v = 0; v < 3; v++) {
+            vs[v][X] = randomCoord(centre[X], spread);
+            vs[v][Y] = randomCoord(centre[Y], spread);
+        }
+
+        n = checkRandom(vs, polygon);
+        num_clipped += (n > 3);
+        num_rejected += (n == 0);
+    }
+
+    for (uint32_t i = 0; i < NUM_RANDOM; i++) {
+        /*
+            The shared edge a to b, with its ends well away from the lines of the edges of the frame and the third
+            vertices of the two triangles well away from it, so that only its crossings lie on both the edges of the
+            frame and its line.
+        */
+        for (uint8_t v = 0; v < 2; v++) {
+            do {
+                shared[0][v][X] = randomCoord(MAX_X / 2, 2 * MAX_X);
+                shared[0][v][Y] = randomCoord(MAX_Y / 2, 2 * MAX_Y);
+            } while (nearEdge(shared[0][v][X], MAX_X) || nearEdge(shared[0][v][Y], MAX_Y));
+        }
+
+        dx = shared[0][1][X] - shared[0][0][X];
+        dy = shared[0][1][Y] - shared[0][0][Y];
+
+        if ( (fabs(dx) + fabs(dy)) < (8 << SUBPIXEL_BITS) ) {
+            continue;
+        }
+
+        t = 0.3 + (0.4 * rand() / RAND_MAX);
+        h = 0.6 + (0.9 * rand() / RAND_MAX);
+
+        /* The first triangle is a, b, c and the second b, a, d, with c and d on either side, both anticlockwise. */
+        shared[0][2][X] = (ScreenCoord) lround(shared[0][0][X] + (t * dx) - (h * dy));
+        shared[0][2][Y] = (ScreenCoord) lround(shared[0][0][Y] + (t * dy) + (h * dx));
+
+        COPY_2D_VERTEX(shared[1][0], shared[0][1]);
+        COPY_2D_VERTEX(shared[1][1], shared[0][0]);
+        shared[1][2][X] = (ScreenCoord) lround(shared[0][0][X] + (t * dx) + (h * dy));
+        shared[1][2][Y] = (ScreenCoord) lround(shared[0][0][Y] + (t * dy) - (h * dx));
+
+        num_found[0] = crossings(polygon, checkRandom(shared[0], polygon), shared[0][0], shared[0][1], found[0]);
+        num_found[1] = crossings(polygon_b, checkRandom(shared[1], polygon_b), shared[0][0], shared[0][1], found[1]);
+
+        num_shared += (num_found[0] != 0);
+
+        if ( !allFound(found[0], num_found[0], found[1], num_found[1]) ||
+            !allFound(found[1], num_found[1], found[0], num_found[0]) ) {
+            fail("found a vertex on the edge it shares with its neighbour that the neighbour did not", shared[0]);
+        }
+    }
+
+    printf("%u failures in clipping %u random triangles (%u clipped to more than 3 vertices, %u rejected), and %u"
+        " pairs with a shared edge crossing the frame.\n", (unsigned int) num_failures, NUM_RANDOM,
+        (unsigned int) num_clipped, (unsigned int) num_rejected, (unsigned int) num_shared);
+
+    return ( (num_failures == 0) && (num_clipped > 0) && (num_rejected > 0) && (num_shared > 0) ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,344 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "clip.h"
+
+/*
+    Checks depth_outcode() and clip_triangle_depth(), with both NEAR_PLANE_CLIPPING and FAR_PLANE_CLIPPING.
+
+    Vertices either side of each plane, and on it, must have the right outcodes, and triangles wholly nearer than
+    the near plane or beyond the far plane must share a bit of them, so are rejected before clipping.
+
+    Random triangles crossing one plane or both, one vertex or two beyond each, are then checked for what any clip
+    must give. Each vertex lies between the planes and is either a vertex of the triangle or lies on one of its edges.
+    Every edge crossing a plane has a vertex there. The polygon keeps the winding of the triangle.
+
+    Last, random pairs of triangles sharing an edge that crosses a plane, taken in opposite directions as by
+    neighbours in a mesh, must find the same vertex where it crosses, to the bit.
+*/
+
+#define NUM_RANDOM 20000
+
+/* How far a vertex found by clipping may lie off an edge of the triangle, in the units of camera space. */
+#define TOLERANCE 0.001
+
+#if (FIXED_POINT_PIPELINE)
+    #define TO_DOUBLE(s) ( (double) (s) / 65536.0 )
+#else
+    #define TO_DOUBLE(s) ( (double) (s) )
+#endif
+
+static uint32_t num_failures = 0;
+
+static void fail(const char *what, const Triangle3D *tri3)
+{
+    if (num_failures++ < 10) {
+        printf("Triangle (%.3f, %.3f, %.3f), (%.3f, %.3f, %.3f), (%.3f, %.3f, %.3f): %s.\n",
+            TO_DOUBLE(tri3->vs[0][X]), TO_DOUBLE(tri3->vs[0][Y]), TO_DOUBLE(tri3->vs[0][Z]),
+            TO_DOUBLE(tri3->vs[1][X]), TO_DOUBLE(tri3->vs[1][Y]), TO_DOUBLE(tri3->vs[1][Z]),
+            TO_DOUBLE(tri3->vs[2][X]), TO_DOUBLE(tri3->vs[2][Y]), TO_DOUBLE(tri3->vs[2][Z]), what);
+    }
+}
+
+static void setVertex(Scalar v[3], double x, double y, double z)
+{
+    v[X] = SCALAR(x);
+    v[Y] = SCALAR(y);
+    v[Z] = SCALAR(z);
+}
+
+static double randomDouble(double min, double max)
+{
+    return min + ((max - min) * rand() / RAND_MAX);
+}
+
+/* Returns the distance of the vertex v from the segment p to q, or from the line through them if line is set. */
+static double distanceFromEdge(const Scalar p[3], const Scalar q[3], const Scalar v[3], uint8_t line)
+{
+    double d[3];
+    double w[3];
+    double t = 0;
+    double length2 = 0;
+    double distance2 = 0;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        d[i] = TO_DOUBLE(q[i]) - TO_DOUBLE(p[i]);
+        w[i] = TO_DOUBLE(v[i]) - TO_DOUBLE(p[i]);
+        t += d[i] * w[i];
+        length2 += d[i] * d[i];
+    }
+
+    t = (length2 == 0) ? 0 : t / length2;
+
+    if (!line) {
+        t = (t < 0) ? 0 : ((t > 1) ? 1 : t);
+    }
+
+    for (uint8_t i = 0; i < 3; i++) {
+        distance2 += (w[i] - (t * d[i])) * (w[i] - (t * d[i]));
+    }
+
+    return sqrt(distance2);
+}
+
+/* Adds the cross product of p to q and p to r to normal, twice the area of the triangle p, q, r along its normal. */
+static void addArea(const Scalar p[3], const Scalar q[3], const Scalar r[3], double normal[3])
+{
+    double u[3];
+    double v[3];
+
+    for (uint8_t i = 0; i < 3; i++) {
+        u[i] = TO_DOUBLE(q[i]) - TO_DOUBLE(p[i]);
+        v[i] = TO_DOUBLE(r[i]) - TO_DOUBLE(p[i]);
+    }
+
+    normal[X] += (u[Y] * v[Z]) - (u[Z] * v[Y]);
+    normal[Y] += (u[Z] * v[X]) - (u[X] * v[Z]);
+    normal[Z] += (u[X] * v[Y]) - (u[Y] * v[X]);
+}
+
+/* Checks the clip of the triangle tri3, which crosses a plane, for what any clip must give. Returns the number of vertices. */
+static uint8_t checkClip(const Triangle3D *tri3, Scalar polygon[DEPTH_CLIP_MAX_VERTICES][3])
+{
+    static const double plane_zs[2] = { NEAR_PLANE_Z, FAR_PLANE_Z };
+    uint8_t codes[3];
+    uint8_t n;
+    uint8_t on_edge;
+    uint8_t found;
+    double plane_z;
+    double z0;
+    double z1;
+    double triangle_normal[3] = { 0, 0, 0 };
+    double polygon_normal[3] = { 0, 0, 0 };
+
+    for (uint8_t i = 0; i < 3; i++) {
+        codes[i] = depth_outcode(tri3->vs[i]);
+    }
+
+    n = clip_triangle_depth(tri3, codes, polygon);
+
+    if ( (n < 3) || (n > DEPTH_CLIP_MAX_VERTICES) ) {
+        fail("clipped to a polygon of too few or too many vertices", tri3);
+        return n;
+    }
+
+    for (uint8_t i = 0; i < n; i++) {
+        if (depth_outcode(polygon[i]) != 0) {
+            fail("clipped to a vertex beyond a plane", tri3);
+            return n;
+        }
+
+        on_edge = 0;
+
+        for (uint8_t j = 0; j < 3; j++) {
+            on_edge = on_edge || (distanceFromEdge(tri3->vs[j], tri3->vs[(j + 1) % 3], polygon[i], 0) <= TOLERANCE);
+        }
+
+        if (!on_edge) {
+            fail("clipped to a vertex off the edges of the triangle", tri3);
+            return n;
+        }
+    }
+
+    /* Each edge that crosses a plane has a vertex on the plane, on the edge. */
+    for (uint8_t j = 0; j < 3; j++) {
+        z0 = TO_DOUBLE(tri3->vs[j][Z]);
+        z1 = TO_DOUBLE(tri3->vs[(j + 1) % 3][Z]);
+
+        for (uint8_t p = 0; p < 2; p++) {
+            plane_z = plane_zs[p];
+
+            if ( ((z0 < plane_z) != (z1 < plane_z)) && (z0 != plane_z) && (z1 != plane_z) ) {
+                found = 0;
+
+                for (uint8_t i = 0; i < n; i++) {
+                    found = found || ( (polygon[i][Z] == SCALAR(plane_z)) &&
+                        (distanceFromEdge(tri3->vs[j], tri3->vs[(j + 1) % 3], polygon[i], 0) <= TOLERANCE) );
+                }
+
+                if (!found) {
+                    fail("clipped without a vertex where an edge crosses a plane", tri3);
+                    return n;
+                }
+            }
+        }
+    }
+
+    addArea(tri3->vs[0], tri3->vs[1], tri3->vs[2], triangle_normal);
+
+    for (uint8_t i = 1; i + 1 < n; i++) {
+        addArea(polygon[0], polygon[i], polygon[i + 1], polygon_normal);
+    }
+
+    if ( (triangle_normal[X] * polygon_normal[X]) + (triangle_normal[Y] * polygon_normal[Y]) +
+        (triangle_normal[Z] * polygon_normal[Z]) < -TOLERANCE ) {
+        fail("clipped to a polygon of the opposite winding", tri3);
+    }
+
+    return n;
+}
+
+/*
+    Returns the vertex of the polygon of n vertices that lies on the plane at plane_z and on the line through a and
+    b, where the edge a to b crosses the plane, or NULL if there is not exactly one.
+*/
+static const Scalar *crossing(Scalar polygon[DEPTH_CLIP_MAX_VERTICES][3], uint8_t n, const Scalar a[3], const Scalar b[3], double plane_z)
+{
+    const Scalar *found = NULL;
+    uint8_t num_found = 0;
+
+    for (uint8_t i = 0; i < n; i++) {
+        if ( (polygon[i][Z] == SCALAR(plane_z)) && (distanceFromEdge(a, b, polygon[i], 1) <= TOLERANCE) ) {
+            found = polygon[i];
+            num_found++;
+        }
+    }
+
+    return (num_found == 1) ? found : NULL;
+}
+
+static void checkOutcode(double z, uint8_t expected)
+{
+    Triangle3D tri3;
+
+    setVertex(tri3.vs[0], 1, -1, z);
+    setVertex(tri3.vs[1], 1, -1, z);
+    setVertex(tri3.vs[2], 1, -1, z);
+
+    if (depth_outcode(tri3.vs[0]) != expected) {
+        fail("given the wrong outcode", &tri3);
+    }
+}
+
+int main(void)
+{
+    Triangle3D tri3;
+    Triangle3D shared[2];
+    Scalar polygon[DEPTH_CLIP_MAX_VERTICES][3];
+    Scalar polygon_b[DEPTH_CLIP_MAX_VERTICES][3];
+    const Scalar *found[2];
+    uint8_t codes[3];
+    uint8_t n;
+    uint8_t inside;
+    int8_t beyond;
+    uint32_t num_crossing = 0;
+    uint32_t num_both = 0;
+    double plane_z;
+    double ab[3];
+    double perp[3];
+    double dot;
+    double length;
+    double ab_length;
+    double t;
+    double h;
+
+    checkOutcode(NEAR_PLANE_Z - 0.01, 1);
+    checkOutcode(NEAR_PLANE_Z, 0);
+    checkOutcode((NEAR_PLANE_Z + FAR_PLANE_Z) / 2, 0);
+    checkOutcode(FAR_PLANE_Z, 0);
+    checkOutcode(FAR_PLANE_Z + 0.01, 2);
+
+    /* Wholly nearer than the near plane and wholly beyond the far plane, across the axis and either side of the camera. */
+    for (uint8_t p = 0; p < 2; p++) {
+        setVertex(tri3.vs[0], -4, -4, p ? FAR_PLANE_Z + 1 : -2);
+        setVertex(tri3.vs[1], 4, -4, p ? FAR_PLANE_Z + 8 : NEAR_PLANE_Z - 0.01);
+        setVertex(tri3.vs[2], 0, 4, p ? FAR_PLANE_Z + 0.01 : 0);
+
+        for (uint8_t i = 0; i < 3; i++) {
+            codes[i] = depth_outcode(tri3.vs[i]);
+        }
+
+        if ( !(codes[0] & codes[1] & codes[2]) || (clip_triangle_depth(&tri3, codes, polygon) != 0) ) {
+            fail("wholly beyond a plane but not rejected", &tri3);
+        }
+    }
+
+    /* One vertex nearer than the near plane, one beyond the far plane: a pentagon. */
+    setVertex(tri3.vs[0], 0, 0, 0);
+    setVertex(tri3.vs[1], 1, 0, FAR_PLANE_Z + 4);
+    setVertex(tri3.vs[2], 0, 1, FAR_PLANE_Z / 2);
+
+    if (checkClip(&tri3, polygon) != 5) {
+        fail("not clipped to a pentagon", &tri3);
+    }
+
+    srand(1);
+
+    for (uint32_t i = 0; i < NUM_RANDOM; i++) {
+        for (uint8_t v = 0; v < 3; v++) {
+            setVertex(tri3.vs[v], randomDouble(-8, 8), randomDouble(-8, 8), randomDouble(-2, FAR_PLANE_Z + 4));
+            codes[v] = depth_outcode(tri3.vs[v]);
+        }
+
+        if ( !(codes[0] | codes[1] | codes[2]) || (codes[0] & codes[1] & codes[2]) ) {
+            continue;
+        }
+
+        n = checkClip(&tri3, polygon);
+        num_crossing++;
+        num_both += ( ((codes[0] | codes[1] | codes[2]) == 3) && (n == 5) );
+    }
+
+    for (uint32_t i = 0; i < NUM_RANDOM; i++) {
+        /*
+            The shared edge a to b crosses one plane, either end between the planes, with its ends well away from it and the third vertices of the
+            two triangles well away from the edge, so that only its crossing lies on both the plane and its line.
+        */
+        plane_z = (i % 2) ? FAR_PLANE_Z : NEAR_PLANE_Z;
+        inside = (i / 2) % 2;
+        beyond = (i % 2) ? 1 : -1;
+
+        setVertex(shared[0].vs[inside], randomDouble(-8, 8), randomDouble(-8, 8), plane_z - (beyond * randomDouble(1, 8)));
+        setVertex(shared[0].vs[!inside], randomDouble(-8, 8), randomDouble(-8, 8), plane_z + (beyond * randomDouble(1, 8)));
+
+        dot = 0;
+        length = 0;
+        ab_length = 0;
+
+        for (uint8_t j = 0; j < 3; j++) {
+            ab[j] = TO_DOUBLE(shared[0].vs[1][j]) - TO_DOUBLE(shared[0].vs[0][j]);
+            perp[j] = randomDouble(-1, 1);
+            dot += ab[j] * perp[j];
+            ab_length += ab[j] * ab[j];
+        }
+
+        for (uint8_t j = 0; j < 3; j++) {
+            perp[j] -= ab[j] * dot / ab_length;
+            length += perp[j] * perp[j];
+        }
+
+        if (length < 0.01) {
+            continue;
+        }
+
+        t = randomDouble(0.3, 0.7);
+        h = randomDouble(0.6, 1.5) * sqrt(ab_length / length);
+
+        /* The first triangle is a, b, c and the second b, a, d, with c and d on either side, so of the same winding. */
+        setVertex(shared[0].vs[2], TO_DOUBLE(shared[0].vs[0][X]) + (t * ab[X]) + (h * perp[X]),
+            TO_DOUBLE(shared[0].vs[0][Y]) + (t * ab[Y]) + (h * perp[Y]), TO_DOUBLE(shared[0].vs[0][Z]) + (t * ab[Z]) + (h * perp[Z]));
+
+        for (uint8_t j = 0; j < 3; j++) {
+            shared[1].vs[0][j] = shared[0].vs[1][j];
+            shared[1].vs[1][j] = shared[0].vs[0][j];
+        }
+
+        setVertex(shared[1].vs[2], TO_DOUBLE(shared[0].vs[0][X]) + (t * ab[X]) - (h * perp[X]),
+            TO_DOUBLE(shared[0].vs[0][Y]) + (t * ab[Y]) - (h * perp[Y]), TO_DOUBLE(shared[0].vs[0][Z]) + (t * ab[Z]) - (h * perp[Z]));
+
+        found[0] = crossing(polygon, checkClip(&shared[0], polygon), shared[0].vs[0], shared[0].vs[1], plane_z);
+        found[1] = crossing(polygon_b, checkClip(&shared[1], polygon_b), shared[0].vs[0], shared[0].vs[1], plane_z);
+
+        if ( (found[0] == NULL) || (found[1] == NULL) || (found[0][X] != found[1][X]) || (found[0][Y] != found[1][Y]) ) {
+            fail("found a vertex on the edge it shares with its neighbour that the neighbour did not", &shared[0]);
+        }
+    }
+
+    printf("%u failures in clipping %u random triangles crossing a plane (%u clipped to both), and %u pairs with a"
+        " shared edge crossing one.\n", (unsigned int) num_failures, (unsigned int) num_crossing,
+        (unsigned int) num_both, NUM_RANDOM);
+
+    return ( (num_failures == 0) && (num_crossing > 0) && (num_both > 0) ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,145 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "projection.h"
+#include "mesh.h"
+
+/*
+    Checks that culling by the normal and culling by the projected area, SCREEN_SPACE_CULLING, cull the same
+    triangles of the cube of graphics_demo.c, but for those within the rounding of the projection of edge on.
+
+    Each triangle of the cube is drawn on its own with drawMesh() and CULL_BACK, and whether it was culled is taken
+    from trianglesCulled. This must match the other mode, found here: the sign of the area of the projected vertices
+    with culling by the normal, the sign of the dot product of the normal with a vertex with SCREEN_SPACE_CULLING.
+    Where they differ, the projected area must be no more than rounding the vertices to the nearest pixel can move
+    it by.
+
+    The rotations of the demo are checked, then random ones, then random ones with the cube translated wholly off
+    the frame, where it must still be culled as on it, as triangles are culled before they are clipped.
+*/
+
+extern const Mesh cube;
+
+#define NUM_RANDOM 20000
+
+static uint32_t num_triangles = 0;
+static uint32_t num_culled = 0;
+static uint32_t num_edge_on = 0;
+static uint32_t num_failures = 0;
+
+/* Returns twice the area of the projected triangle, positive if it is front facing. */
+static int32_t projectedArea(const ScreenCoord projected[3][2])
+{
+    return ((int32_t) (projected[1][X] - projected[0][X]) * (projected[2][Y] - projected[0][Y])) -
+        ((int32_t) (projected[1][Y] - projected[0][Y]) * (projected[2][X] - projected[0][X]));
+}
+
+/* Returns how far rounding each vertex to the nearest 1/2^SUBPIXEL_BITS of a pixel may move twice the area. */
+static double roundingBound(const ScreenCoord projected[3][2])
+{
+    double perimeter = 0;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        perimeter += hypot(projected[(i + 1) % 3][X] - projected[i][X], projected[(i + 1) % 3][Y] - projected[i][Y]);
+    }
+
+    /* Each vertex moves by at most half a unit on each axis, so moves each edge by less than a unit across it. */
+    return perimeter + 2;
+}
+
+static void checkModelView(const ModelView *mv, const char *what)
+{
+    static VertexCache cache;
+    static uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS];
+    Mesh triangle = cube;
+    ScreenCoord projected[3][2];
+    uint8_t culled;
+    uint8_t other_culled;
+    int32_t area;
+
+    transform_mesh(&cube, mv, &cache);
+
+    for (uint16_t tri_num = 0; tri_num < cube.num_triangles; tri_num++) {
+        triangle.num_triangles = 1;
+        triangle.indices = &cube.indices[tri_num];
+        triangle.colours = &cube.colours[tri_num];
+
+        trianglesCulled = 0;
+        drawMesh(frame, &triangle, &cache, CULL_BACK);
+        culled = (trianglesCulled != 0);
+
+        for (uint8_t i = 0; i < 3; i++) {
+            COPY_2D_VERTEX(projected[i], cache.projected[cube.indices[tri_num][i]]);
+        }
+
+        area = projectedArea(projected);
+
+        #if (SCREEN_SPACE_CULLING)
+            Triangle3D tri3;
+
+            for (uint8_t i = 0; i < 3; i++) {
+                tri3.vs[i][X] = cache.vs[cube.indices[tri_num][i]][X];
+                tri3.vs[i][Y] = cache.vs[cube.indices[tri_num][i]][Y];
+                tri3.vs[i][Z] = cache.vs[cube.indices[tri_num][i]][Z];
+            }
+
+            find_triangle_normal(&tri3);
+            other_culled = !(DOT_PRODUCT_3D(tri3.normal, tri3.vs[0]) > 0);
+        #else
+            other_culled = !(area > 0);
+        #endif
+
+        num_triangles++;
+        num_culled += culled;
+
+        if (culled == other_culled) {
+            continue;
+        }
+
+        num_edge_on++;
+
+        if ( (fabs((double) area) > roundingBound(projected)) && (num_failures++ < 10) ) {
+            printf("Triangle %u of %s is culled by one mode and not the other, with a projected area of %d.\n",
+                tri_num, what, (int) area);
+        }
+    }
+}
+
+int main(void)
+{
+    ModelView mv;
+
+    srand(1);
+
+    for (uint8_t rotation_num = 0; rotation_num < 255; rotation_num++) {
+        model_view_identity(&mv);
+        model_view_rotate(&mv, ROTATION_RATE_THETA * rotation_num, ROTATION_RATE_PHI * rotation_num);
+        model_view_translate(&mv, SCALAR(0), SCALAR(0), SCALAR(Z_TRANSLATION));
+
+        checkModelView(&mv, "a rotation of the demo");
+    }
+
+    for (uint32_t i = 0; i < NUM_RANDOM; i++) {
+        model_view_identity(&mv);
+        model_view_rotate(&mv, rand() % 256, rand() % 256);
+        model_view_translate(&mv, SCALAR(0), SCALAR(0), SCALAR(Z_TRANSLATION));
+
+        checkModelView(&mv, "a random rotation");
+    }
+
+    for (uint32_t i = 0; i < NUM_RANDOM; i++) {
+        model_view_identity(&mv);
+        model_view_rotate(&mv, rand() % 256, rand() % 256);
+        model_view_translate(&mv, SCALAR((i % 2) ? 5 : -5), SCALAR((i % 4 < 2) ? 5 : -5), SCALAR(Z_TRANSLATION));
+
+        checkModelView(&mv, "a random rotation off the frame");
+    }
+
+    printf("%u of %u triangles culled, %u culled by one mode and not the other, %u of them beyond the rounding of"
+        " edge on.\n", (unsigned int) num_culled, (unsigned int) num_triangles, (unsigned int) num_edge_on,
+        (unsigned int) num_failures);
+
+    return ( (num_failures == 0) && (num_culled > 0) ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
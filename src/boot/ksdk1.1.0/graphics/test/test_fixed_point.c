@@ -0,0 +1,221 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "projection.h"
+#include "mesh.h"
+
+/*
+    Measures the error of the fixed point geometry pipeline against the float one, over a whole rotation of the cube
+    demo, and checks it against the bounds below.
+
+    The file is built twice. The float build (FIXED_POINT_PIPELINE 0) writes, for every frame, the camera space and
+    projected vertices of the cube and the normal, facing (the dot product culled on) and relative intensity of each
+    triangle to the file named by its argument. The fixed point build computes the same and compares them with the
+    file, printing the largest errors.
+
+    The relative intensity and the facing are thresholds of the normal and so may differ, but only where the float
+    value lies within the error bound of the threshold. A projected coordinate may differ by a pixel, which is why
+    some frames of the two pipelines differ.
+*/
+
+/* Q8.8 matrix coefficients are within 1/512 of the float ones, and three are summed per component. */
+#define MAX_VERTEX_ERROR 0.006
+
+/* About twice the largest errors measured, 0.0035 and 0.0098, as the cross product has no simple bound. */
+#define MAX_NORMAL_ERROR 0.007
+#define MAX_FACING_ERROR 0.02
+
+/* In units of a pixel. */
+#define MAX_PROJECTED_ERROR 1
+
+extern const Mesh cube;
+
+static double toDouble(Scalar s)
+{
+    #if (FIXED_POINT_PIPELINE)
+        return (double) s / FIXED_Q16_ONE;
+    #else
+        return s;
+    #endif
+}
+
+#if (FIXED_POINT_PIPELINE)
+
+/* Largest error seen and the number of values compared. */
+typedef struct {
+    double max_error;
+    uint32_t num_values;
+    uint32_t num_different;
+} ErrorCount;
+
+static uint32_t numFailures = 0;
+
+static void countError(ErrorCount *count, double error, double bound, const char *what, int frame)
+{
+    error = fabs(error);
+
+    count->num_values++;
+
+    if (error > 0) {
+        count->num_different++;
+    }
+
+    if (error > count->max_error) {
+        count->max_error = error;
+    }
+
+    if (error > bound) {
+        if (numFailures++ < 10) {
+            printf("Frame %d: %s error %g is above its bound of %g.\n", frame, what, error, bound);
+        }
+    }
+}
+
+/* Non zero if value lies within bound of threshold, where a threshold of a value with that error may differ. */
+static int nearThreshold(double value, double threshold, double bound)
+{
+    return fabs(value - threshold) <= bound;
+}
+
+static ErrorCount vertexErrors;
+static ErrorCount normalErrors;
+static ErrorCount facingErrors;
+static ErrorCount projectedErrors;
+static uint32_t numIntensities = 0;
+static uint32_t intensitiesDifferent = 0;
+static uint32_t facingsDifferent = 0;
+
+#endif
+
+int main(int argc, char **argv)
+{
+    ModelView model_view;
+    VertexCache cache;
+    Triangle3D tri3;
+    Triangle2D tri2;
+    FILE *reference;
+
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s REFERENCE_FILE\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    reference = fopen(argv[1], FIXED_POINT_PIPELINE ? "r" : "w");
+
+    if (reference == NULL) {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    for (int frame = 0; frame < 255; frame++) {
+        /* As graphicsDemo(). */
+        model_view_identity(&model_view);
+        model_view_rotate(&model_view, ROTATION_RATE_THETA * frame, ROTATION_RATE_PHI * frame);
+        model_view_translate(&model_view, SCALAR(0), SCALAR(0), SCALAR(Z_TRANSLATION));
+
+        transform_mesh(&cube, &model_view, &cache);
+
+        for (uint16_t v = 0; v < cube.num_vertices; v++) {
+            #if (FIXED_POINT_PIPELINE)
+                double expected[3];
+                int expected_projected[2];
+
+                if (fscanf(reference, "%lf %lf %lf %d %d", &expected[X], &expected[Y], &expected[Z],
+                    &expected_projected[X], &expected_projected[Y]) != 5) {
+                    fprintf(stderr, "%s ends early.\n", argv[1]);
+                    return EXIT_FAILURE;
+                }
+
+                for (uint8_t axis = X; axis <= Z; axis++) {
+                    countError(&vertexErrors, toDouble(cache.vs[v][axis]) - expected[axis], MAX_VERTEX_ERROR, "vertex", frame);
+                }
+
+                for (uint8_t axis = X; axis <= Y; axis++) {
+                    countError(&projectedErrors, (double) (cache.projected[v][axis] - expected_projected[axis]) / (1 << SUBPIXEL_BITS),
+                        MAX_PROJECTED_ERROR, "projected coordinate", frame);
+                }
+            #else
+                fprintf(reference, "%.9g %.9g %.9g %d %d\n", cache.vs[v][X], cache.vs[v][Y], cache.vs[v][Z],
+                    cache.projected[v][X], cache.projected[v][Y]);
+            #endif
+        }
+
+        for (uint16_t t = 0; t < cube.num_triangles; t++) {
+            double facing;
+
+            for (uint8_t i = 0; i < 3; i++) {
+                for (uint8_t axis = X; axis <= Z; axis++) {
+                    tri3.vs[i][axis] = cache.vs[cube.indices[t][i]][axis];
+                }
+            }
+
+            find_triangle_normal(&tri3);
+            facing = toDouble(DOT_PRODUCT_3D(tri3.normal, tri3.vs[0]));
+            shade(&tri3, &tri2);
+
+            #if (FIXED_POINT_PIPELINE)
+                double expected_normal[3];
+                double expected_facing;
+                int expected_intensity;
+                double normal_z;
+
+                if (fscanf(reference, "%lf %lf %lf %lf %d", &expected_normal[X], &expected_normal[Y], &expected_normal[Z],
+                    &expected_facing, &expected_intensity) != 5) {
+                    fprintf(stderr, "%s ends early.\n", argv[1]);
+                    return EXIT_FAILURE;
+                }
+
+                for (uint8_t axis = X; axis <= Z; axis++) {
+                    countError(&normalErrors, toDouble(tri3.normal[axis]) - expected_normal[axis], MAX_NORMAL_ERROR, "normal", frame);
+                }
+
+                countError(&facingErrors, facing - expected_facing, MAX_FACING_ERROR, "facing", frame);
+
+                if ( (facing > 0) != (expected_facing > 0) ) {
+                    facingsDifferent++;
+
+                    if (!nearThreshold(expected_facing, 0, MAX_FACING_ERROR)) {
+                        numFailures++;
+                        printf("Frame %d: triangle %d faces the other way, at %g.\n", frame, t, expected_facing);
+                    }
+                }
+
+                numIntensities++;
+                normal_z = fabs(expected_normal[Z]);
+
+                if (tri2.relative_intensity != expected_intensity) {
+                    intensitiesDifferent++;
+
+                    if ( !nearThreshold(normal_z, RELATIVE_INTENSITY_1_THRESHOLD, MAX_NORMAL_ERROR) &&
+                        !nearThreshold(normal_z, RELATIVE_INTENSITY_2_THRESHOLD, MAX_NORMAL_ERROR) ) {
+                        numFailures++;
+                        printf("Frame %d: triangle %d has relative intensity %d, not %d.\n", frame, t,
+                            tri2.relative_intensity, expected_intensity);
+                    }
+                }
+            #else
+                fprintf(reference, "%.9g %.9g %.9g %.9g %d\n", tri3.normal[X], tri3.normal[Y], tri3.normal[Z],
+                    facing, tri2.relative_intensity);
+            #endif
+        }
+    }
+
+    fclose(reference);
+
+    #if (FIXED_POINT_PIPELINE)
+        printf("Largest error against the float pipeline over %d frames:\n", 255);
+        printf("  camera space vertex %.6f (%u of %u differ)\n", vertexErrors.max_error,
+            (unsigned int) vertexErrors.num_different, (unsigned int) vertexErrors.num_values);
+        printf("  normal %.6f, facing %.6f\n", normalErrors.max_error, facingErrors.max_error);
+        printf("  projected coordinate %.2f pixels (%u of %u differ)\n", projectedErrors.max_error,
+            (unsigned int) projectedErrors.num_different, (unsigned int) projectedErrors.num_values);
+        printf("  relative intensity differs for %u of %u triangles, facing for %u\n",
+            (unsigned int) intensitiesDifferent, (unsigned int) numIntensities, (unsigned int) facingsDifferent);
+
+        return (numFailures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    #else
+        return EXIT_SUCCESS;
+    #endif
+}
@@ -0,0 +1,140 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "draw_triangle.h"
+
+/*
+    Checks the half-space rasteriser of drawTriangle() against a brute-force reference, for the block size of the build.
+
+    Random triangles, large and small, with their vertices anywhere in the frame to 1/2^SUBPIXEL_BITS of a pixel, are
+    drawn over a frame of random pixels. The reference tests the centre of every pixel of the frame against the three
+    edges in double precision, and draws it if it is inside all three, or on an edge that has the triangle below it if
+    horizontal, or to its right otherwise (the top-left rule). Triangles of no area are not drawn. The frames must
+    match, pixel for pixel.
+*/
+
+#define FRAME_BYTES (FRAME_TRUE_ROWS * FRAME_TRUE_COLS)
+
+#define MAX_X ( (FRAME_NUM_COLS - 1) << SUBPIXEL_BITS )
+#define MAX_Y ( (FRAME_NUM_ROWS - 1) << SUBPIXEL_BITS )
+
+/*
+    Returns whether the pixel centre (x, row) is drawn by the edge from vertex i to vertex i + 1 of the triangle
+    (xs, rows), being in pixels with C style rows, taken in the order that gives it a positive area.
+*/
+static uint8_t insideEdge(const double xs[3], const double rows[3], uint8_t i, double x, double row)
+{
+    uint8_t j = (i + 1) % 3;
+    uint8_t k = (i + 2) % 3;
+    double e = ((xs[j] - xs[i]) * (row - rows[i])) - ((rows[j] - rows[i]) * (x - xs[i]));
+
+    if (e != 0) {
+        return e > 0;
+    }
+
+    if (rows[i] == rows[j]) {
+        /* A top edge has the triangle below it, at greater rows. */
+        return rows[k] > rows[i];
+    }
+
+    /* A left edge has the triangle to its right, where the third vertex lies beyond the edge at its row. */
+    return xs[k] > xs[i] + ((xs[j] - xs[i]) * (rows[k] - rows[i]) / (rows[j] - rows[i]));
+}
+
+static void drawReference(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], const Triangle2D *tri)
+{
+    double xs[3];
+    double rows[3];
+    double temp;
+    double area;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        xs[i] = (double) tri->vs[i][X] / (1 << SUBPIXEL_BITS);
+        rows[i] = (FRAME_NUM_ROWS - 1) - ((double) tri->vs[i][Y] / (1 << SUBPIXEL_BITS));
+    }
+
+    area = ((xs[1] - xs[0]) * (rows[2] - rows[0])) - ((rows[1] - rows[0]) * (xs[2] - xs[0]));
+
+    if (area == 0) {
+        return;
+    }
+
+    if (area < 0) {
+        temp = xs[1];
+        xs[1] = xs[2];
+        xs[2] = temp;
+
+        temp = rows[1];
+        rows[1] = rows[2];
+        rows[2] = temp;
+    }
+
+    for (uint8_t row = 0; row < FRAME_NUM_ROWS; row++) {
+        for (uint8_t col = 0; col < FRAME_NUM_COLS; col++) {
+            if (insideEdge(xs, rows, 0, col, row) && insideEdge(xs, rows, 1, col, row) && insideEdge(xs, rows, 2, col, row)) {
+                drawPixel(frame, col, (FRAME_NUM_ROWS - 1) - row, tri->colour, tri->relative_intensity);
+            }
+        }
+    }
+}
+
+/* Returns a random coordinate from 0 to max, within spread of centre if spread is less than max. */
+static VertexCoord randomCoord(int32_t centre, int32_t spread, int32_t max)
+{
+    int32_t coord = centre - spread + (rand() % (2 * spread + 1));
+
+    return (VertexCoord) ( (coord < 0) ? 0 : ((coord > max) ? max : coord) );
+}
+
+int main(void)
+{
+    static uint8_t background[FRAME_BYTES];
+    static uint8_t expected[FRAME_TRUE_ROWS][FRAME_TRUE_COLS];
+    static uint8_t actual[FRAME_TRUE_ROWS][FRAME_TRUE_COLS];
+    Triangle2D tri;
+    int32_t spread;
+    int32_t centre[2];
+    uint32_t num_drawn = 0;
+    uint32_t num_failures = 0;
+
+    srand(1);
+
+    for (uint32_t i = 0; i < FRAME_BYTES; i++) {
+        background[i] = (uint8_t) rand();
+    }
+
+    for (uint32_t i = 0; i < 20000; i++) {
+        /* A quarter of the triangles span the frame, the rest a few pixels or less. */
+        spread = (i % 4) ? ((1 + rand() % 6) << SUBPIXEL_BITS) : (MAX_X + MAX_Y);
+        centre[X] = rand() % (MAX_X + 1);
+        centre[Y] = rand() % (MAX_Y + 1);
+
+        for (uint8_t v = 0; v < 3; v++) {
+            tri.vs[v][X] = randomCoord(centre[X], spread, MAX_X);
+            tri.vs[v][Y] = randomCoord(centre[Y], spread, MAX_Y);
+        }
+
+        tri.colour = R + (rand() % 3);
+        tri.relative_intensity = rand() % (MAX_RELATIVE_INTENSITY + 1);
+
+        memcpy(expected, background, FRAME_BYTES);
+        memcpy(actual, background, FRAME_BYTES);
+
+        drawReference(expected, &tri);
+        drawTriangle(actual, tri);
+
+        num_drawn += (memcmp(expected, background, FRAME_BYTES) != 0);
+
+        if ( (memcmp(expected, actual, FRAME_BYTES) != 0) && (num_failures++ < 10) ) {
+            printf("Triangle (%d, %d), (%d, %d), (%d, %d) differs from the reference.\n", tri.vs[0][X], tri.vs[0][Y],
+                tri.vs[1][X], tri.vs[1][Y], tri.vs[2][X], tri.vs[2][Y]);
+        }
+    }
+
+    printf("%u of 20000 triangles (%u covering a pixel centre) differ from the reference, with %dx%d blocks.\n",
+        (unsigned int) num_failures, (unsigned int) num_drawn, HALF_SPACE_BLOCK_COLS, HALF_SPACE_BLOCK_ROWS);
+
+    return ( (num_failures == 0) && (num_drawn > 0) ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
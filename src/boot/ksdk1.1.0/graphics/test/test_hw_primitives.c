@@ -0,0 +1,125 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "devSSD1331.h"
+#include "gdram_sim.h"
+
+/*
+    Checks what hwClearFrame(), hwFillRect() and hwDrawLine() leave in the simulated GDRAM.
+
+    GDRAM outside of the frame window is filled with a pattern first. hwClearFrame() must clear the window to black
+    and nothing else. Random rectangles, with their corners given in either order, must then each fill exactly the
+    rectangle in the colour of their pixel value, as must horizontal and vertical lines, whose pixels do not depend
+    on how the SSD1331 steps a sloped line. Frame coordinates have (0, 0) at the bottom left.
+*/
+
+#define FIRST_COL ( (GDRAM_SIM_COLS / 2) - (FRAME_SCREEN_COLS / 2) )
+#define FIRST_ROW ( (GDRAM_SIM_ROWS / 2) - (FRAME_SCREEN_ROWS / 2) )
+
+#define PATTERN 0x5A5A
+
+static uint16_t expected[GDRAM_SIM_ROWS][GDRAM_SIM_COLS];
+
+/* Sets the pixels of expected from frame column x0 to x1 and row y0 to y1, in either order, to pixel_value. */
+static void expectRect(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t pixel_value)
+{
+    uint8_t x_min = (x0 < x1) ? x0 : x1;
+    uint8_t x_max = (x0 < x1) ? x1 : x0;
+    uint8_t y_min = (y0 < y1) ? y0 : y1;
+    uint8_t y_max = (y0 < y1) ? y1 : y0;
+
+    for (uint8_t y = y_min; y <= y_max; y++) {
+        for (uint8_t x = x_min; x <= x_max; x++) {
+            expected[FIRST_ROW + FRAME_NUM_ROWS - 1 - y][FIRST_COL + x] = pixelValueToColour(pixel_value);
+        }
+    }
+}
+
+static uint8_t check(const char *what)
+{
+    for (int row = 0; row < GDRAM_SIM_ROWS; row++) {
+        for (int col = 0; col < GDRAM_SIM_COLS; col++) {
+            if (gdramSim[row][col] != expected[row][col]) {
+                printf("After %s, GDRAM (%d, %d) is %04x rather than %04x.\n", what, row, col, gdramSim[row][col],
+                    expected[row][col]);
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+int main(void)
+{
+    uint8_t point_0[2];
+    uint8_t point_1[2];
+    uint8_t x0;
+    uint8_t y0;
+    uint8_t x1;
+    uint8_t y1;
+    uint8_t pixel_value;
+    uint8_t line_value;
+    uint32_t num_failures = 0;
+
+    srand(1);
+
+    gdramSimReset();
+    devSSD1331init();
+
+    for (int row = 0; row < GDRAM_SIM_ROWS; row++) {
+        for (int col = 0; col < GDRAM_SIM_COLS; col++) {
+            gdramSim[row][col] = PATTERN;
+            expected[row][col] = PATTERN;
+        }
+    }
+
+    hwClearFrame();
+    expectRect(0, 0, FRAME_NUM_COLS - 1, FRAME_NUM_ROWS - 1, 0);
+    num_failures += check("hwClearFrame()");
+
+    for (int i = 0; i < 1000; i++) {
+        x0 = (uint8_t) (rand() % FRAME_NUM_COLS);
+        y0 = (uint8_t) (rand() % FRAME_NUM_ROWS);
+        x1 = (uint8_t) (rand() % FRAME_NUM_COLS);
+        y1 = (uint8_t) (rand() % FRAME_NUM_ROWS);
+
+        /* A colour R, G or B in the lower 2 bits and a relative intensity in the upper 2. */
+        pixel_value = (uint8_t) ((rand() % 3) + 1 + ((rand() % (MAX_RELATIVE_INTENSITY + 1)) << PIXELS_PER_BYTE));
+        line_value = (uint8_t) ((rand() % 3) + 1 + ((rand() % (MAX_RELATIVE_INTENSITY + 1)) << PIXELS_PER_BYTE));
+
+        hwFillRect(x0, y0, x1, y1, pixel_value);
+        expectRect(x0, y0, x1, y1, pixel_value);
+
+        if (check("hwFillRect()")) {
+            printf("Rectangle (%d, %d) to (%d, %d), pixel value %d.\n", x0, y0, x1, y1, pixel_value);
+            num_failures++;
+            memcpy(expected, gdramSim, sizeof(expected));
+        }
+
+        /* A horizontal line, then a vertical one. */
+        point_0[X] = x0;
+        point_0[Y] = y0;
+        point_1[X] = (i % 2) ? x0 : x1;
+        point_1[Y] = (i % 2) ? y1 : y0;
+
+        hwDrawLine(point_0, point_1, line_value);
+        expectRect(point_0[X], point_0[Y], point_1[X], point_1[Y], line_value);
+
+        if (check("hwDrawLine()")) {
+            printf("Line (%d, %d) to (%d, %d), pixel value %d.\n", point_0[X], point_0[Y], point_1[X], point_1[Y], line_value);
+            num_failures++;
+            memcpy(expected, gdramSim, sizeof(expected));
+        }
+    }
+
+    hwClearFrame();
+    expectRect(0, 0, FRAME_NUM_COLS - 1, FRAME_NUM_ROWS - 1, 0);
+    num_failures += check("the last hwClearFrame()");
+
+    printf("%u of 2002 commands left GDRAM other than expected.\n", (unsigned int) num_failures);
+
+    return (num_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
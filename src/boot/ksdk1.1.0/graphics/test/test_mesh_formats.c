@@ -0,0 +1,125 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "projection.h"
+#include "mesh.h"
+
+/*
+    Checks the int16_t and delta coded vertex formats of mesh_decode_vertex(), and drawMeshUncached(), against the
+    int8_t cube of graphics_demo.c.
+
+    The fixtures hold the same corners as the int8_t cube at the same scale, so decode to the same Scalars. Every
+    rotation of the demo is drawn from each through the VertexCache, and from the cube and the int16_t fixture with
+    drawMeshUncached(), and each frame must match that of the cube. drawMeshUncached() must draw nothing of the
+    delta coded fixture.
+*/
+
+extern const Mesh cube;
+
+/* The corners of the cube. */
+static const int16_t cube_int16_vertices[NUM_VERTICES][3] =
+{
+    {-127, -127, -127},
+    {127, -127, -127},
+    {-127, 127, -127},
+    {127, 127, -127},
+    {-127, -127, 127},
+    {127, -127, 127},
+    {-127, 127, 127},
+    {127, 127, 127}
+};
+
+/* The same corners, each as its difference from the one before, the first from (0, 0, 0). */
+static const int16_t cube_delta_vertices[NUM_VERTICES][3] =
+{
+    {-127, -127, -127},
+    {254, 0, 0},
+    {-254, 254, 0},
+    {254, 0, 0},
+    {-254, -254, 254},
+    {254, 0, 0},
+    {-254, 254, 0},
+    {254, 0, 0}
+};
+
+#define FRAME_BYTES (FRAME_TRUE_ROWS * FRAME_TRUE_COLS)
+
+/* Draws rotation rotation_num of the demo from mesh into frame, through the VertexCache unless uncached. */
+static void drawRotation(uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS], const Mesh *mesh, uint8_t rotation_num, uint8_t uncached)
+{
+    static VertexCache cache;
+    ModelView mv;
+
+    model_view_identity(&mv);
+    model_view_rotate(&mv, ROTATION_RATE_THETA * rotation_num, ROTATION_RATE_PHI * rotation_num);
+    model_view_translate(&mv, SCALAR(0), SCALAR(0), SCALAR(Z_TRANSLATION));
+
+    memset(frame, 0, FRAME_BYTES);
+
+    if (uncached) {
+        drawMeshUncached(frame, mesh, &mv, CULL_BACK);
+    } else {
+        transform_mesh(mesh, &mv, &cache);
+        drawMesh(frame, mesh, &cache, CULL_BACK);
+    }
+}
+
+int main(void)
+{
+    static uint8_t expected[FRAME_TRUE_ROWS][FRAME_TRUE_COLS];
+    static uint8_t actual[FRAME_TRUE_ROWS][FRAME_TRUE_COLS];
+    static const uint8_t blank[FRAME_BYTES];
+    uint32_t num_failures = 0;
+
+    const Mesh cube_int16 =
+    {
+        NUM_VERTICES, NUM_TRIANGLES, MESH_VERTEX_INT16, 0, cube.scale,
+        cube_int16_vertices, cube.indices, cube.colours
+    };
+
+    const Mesh cube_delta =
+    {
+        NUM_VERTICES, NUM_TRIANGLES, MESH_VERTEX_INT16, 1, cube.scale,
+        cube_delta_vertices, cube.indices, cube.colours
+    };
+
+    const struct {
+        const char *name;
+        const Mesh *mesh;
+        uint8_t uncached;
+    } candidates[] = {
+        {"int16_t", &cube_int16, 0},
+        {"delta coded int16_t", &cube_delta, 0},
+        {"int8_t uncached", &cube, 1},
+        {"int16_t uncached", &cube_int16, 1}
+    };
+
+    for (uint8_t rotation_num = 0; rotation_num < 255; rotation_num++) {
+        drawRotation(expected, &cube, rotation_num, 0);
+
+        if (memcmp(expected, blank, FRAME_BYTES) == 0) {
+            printf("Rotation %d of the cube is blank.\n", rotation_num);
+            num_failures++;
+        }
+
+        for (uint8_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++) {
+            drawRotation(actual, candidates[i].mesh, rotation_num, candidates[i].uncached);
+
+            if ((memcmp(expected, actual, FRAME_BYTES) != 0) && (num_failures++ < 10)) {
+                printf("Rotation %d of the %s cube differs.\n", rotation_num, candidates[i].name);
+            }
+        }
+
+        drawRotation(actual, &cube_delta, rotation_num, 1);
+
+        if ((memcmp(actual, blank, FRAME_BYTES) != 0) && (num_failures++ < 10)) {
+            printf("Rotation %d of the delta coded cube was drawn uncached.\n", rotation_num);
+        }
+    }
+
+    printf("%u frames differ from those of the int8_t cube.\n", (unsigned int) num_failures);
+
+    return (num_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,73 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "devSSD1331.h"
+#include "gdram_sim.h"
+
+/*
+    Checks that writeFrame() shows each pixel of the frame as a RENDER_SCALE x RENDER_SCALE block of GDRAM.
+
+    Frames of random pixels are sent, and after each GDRAM must hold the colour of every pixel of the frame over its
+    block of the window centred on the screen, with the rest of GDRAM left as it was. The other scanout options are
+    checked against this build frame for frame, see CMakeLists.txt.
+*/
+
+#define FIRST_COL ( (GDRAM_SIM_COLS / 2) - (FRAME_SCREEN_COLS / 2) )
+#define FIRST_ROW ( (GDRAM_SIM_ROWS / 2) - (FRAME_SCREEN_ROWS / 2) )
+
+#define PATTERN 0x5A5A
+
+int main(void)
+{
+    static uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS];
+    uint16_t expected;
+    uint8_t pixel_value;
+    uint32_t num_failures = 0;
+
+    srand(1);
+
+    gdramSimReset();
+    devSSD1331init();
+
+    for (int row = 0; row < GDRAM_SIM_ROWS; row++) {
+        for (int col = 0; col < GDRAM_SIM_COLS; col++) {
+            gdramSim[row][col] = PATTERN;
+        }
+    }
+
+    for (int i = 0; i < 100; i++) {
+        for (uint8_t row = 0; row < FRAME_TRUE_ROWS; row++) {
+            for (uint8_t col = 0; col < FRAME_TRUE_COLS; col++) {
+                frame[row][col] = (uint8_t) rand();
+            }
+        }
+
+        writeFrame(frame);
+        waitForFrame();
+
+        for (int row = 0; row < GDRAM_SIM_ROWS; row++) {
+            for (int col = 0; col < GDRAM_SIM_COLS; col++) {
+                int frame_row = (row - FIRST_ROW) / RENDER_SCALE;
+                int frame_col = (col - FIRST_COL) / RENDER_SCALE;
+
+                if ( (row < FIRST_ROW) || (row >= FIRST_ROW + FRAME_SCREEN_ROWS) || (col < FIRST_COL) ||
+                    (col >= FIRST_COL + FRAME_SCREEN_COLS) ) {
+                    expected = PATTERN;
+                } else {
+                    /* Two pixels to a byte, the first in the lower nibble. */
+                    pixel_value = (frame[frame_row][frame_col / PIXELS_PER_BYTE] >> (BITS_PER_PIXEL * (frame_col % PIXELS_PER_BYTE))) & PIXEL_BITMASK;
+                    expected = pixelValueToColour(pixel_value);
+                }
+
+                if ( (gdramSim[row][col] != expected) && (num_failures++ < 10) ) {
+                    printf("GDRAM (%d, %d) of frame %d is %04x rather than %04x.\n", row, col, i, gdramSim[row][col], expected);
+                }
+            }
+        }
+    }
+
+    printf("%u pixels of GDRAM differ from the frames scaled by %d.\n", (unsigned int) num_failures, RENDER_SCALE);
+
+    return (num_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,121 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "devSSD1331.h"
+#include "gdram_sim.h"
+
+/*
+    Checks that with ROW_SIGNATURES, a row left stale on the display by a signature collision is refreshed within
+    FRAME_NUM_ROWS frames, however long the frame stays the same.
+
+    A frame of random rows is sent until the display holds it. One row is then changed to a copy of another row,
+    with its first and last bytes set such that it keeps the CRC-8 signature of the row it replaces, and the new frame
+    is sent over and over. The changed row must be stale at first, showing that the collision was made, and must then
+    match its copy on the display within FRAME_NUM_ROWS frames.
+*/
+
+/* Far from the refresh row once the first frame has been sent FRAME_NUM_ROWS + 1 times. */
+#define CHANGED_ROW 20
+#define COPIED_ROW 5
+
+/* The signature of writeFrame(), CRC-8 with the polynomial x^8 + x^2 + x + 1. */
+static uint8_t crc8(const uint8_t *bytes, uint8_t num_bytes)
+{
+    uint8_t crc = 0;
+
+    for (uint8_t i = 0; i < num_bytes; i++) {
+        crc ^= bytes[i];
+
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t) ((crc << 1) ^ 0x07) : (uint8_t) (crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+int main(void)
+{
+    static uint8_t frame[FRAME_TRUE_ROWS][FRAME_TRUE_COLS];
+    static uint16_t converged[GDRAM_SIM_ROWS][GDRAM_SIM_COLS];
+    uint8_t signature;
+    int changed = -1;
+    int stale_frames = 0;
+
+    srand(1);
+
+    for (uint8_t row = 0; row < FRAME_TRUE_ROWS; row++) {
+        for (uint8_t col = 0; col < FRAME_TRUE_COLS; col++) {
+            frame[row][col] = (uint8_t) rand();
+        }
+    }
+
+    /* Make the changed row collide with the copied row: the same signature, different first bytes. */
+    signature = crc8(frame[COPIED_ROW], FRAME_TRUE_COLS);
+    frame[CHANGED_ROW][0] = frame[COPIED_ROW][0] ^ 1;
+
+    for (int last = 0; last < 256; last++) {
+        frame[CHANGED_ROW][FRAME_TRUE_COLS - 1] = (uint8_t) last;
+
+        if (crc8(frame[CHANGED_ROW], FRAME_TRUE_COLS) == signature) {
+            break;
+        }
+    }
+
+    gdramSimReset();
+    devSSD1331init();
+
+    /* Every row is refreshed within FRAME_NUM_ROWS frames, whatever its signature. */
+    for (uint8_t i = 0; i <= FRAME_NUM_ROWS; i++) {
+        writeFrame(frame);
+        waitForFrame();
+    }
+
+    memcpy(converged, gdramSim, sizeof(converged));
+    memcpy(frame[CHANGED_ROW], frame[COPIED_ROW], FRAME_TRUE_COLS);
+
+    for (uint8_t i = 0; i <= FRAME_NUM_ROWS; i++) {
+        writeFrame(frame);
+        waitForFrame();
+
+        changed = -1;
+
+        for (int row = 0; row < GDRAM_SIM_ROWS; row++) {
+            if (memcmp(converged[row], gdramSim[row], sizeof(converged[row])) != 0) {
+                if (changed != -1) {
+                    printf("Rows %d and %d of GDRAM changed, not only the one.\n", changed, row);
+                    return EXIT_FAILURE;
+                }
+
+                changed = row;
+            }
+        }
+
+        if (changed != -1) {
+            break;
+        }
+
+        stale_frames++;
+    }
+
+    if (stale_frames == 0) {
+        printf("The changed row was sent at once, so no collision was made.\n");
+        return EXIT_FAILURE;
+    }
+
+    if (changed == -1) {
+        printf("The changed row was still stale after %d frames.\n", stale_frames);
+        return EXIT_FAILURE;
+    }
+
+    if (memcmp(gdramSim[changed], gdramSim[changed - CHANGED_ROW + COPIED_ROW], sizeof(gdramSim[changed])) != 0) {
+        printf("Row %d of GDRAM changed, but not to the copied row.\n", changed);
+        return EXIT_FAILURE;
+    }
+
+    printf("The row changed by a collision was stale for %d frames, against a bound of %d.\n", stale_frames, FRAME_NUM_ROWS);
+
+    return EXIT_SUCCESS;
+}
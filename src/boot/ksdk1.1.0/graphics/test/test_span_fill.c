@@ -0,0 +1,67 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "draw_line.h"
+
+/*
+    Checks drawHorizontalLine() against drawPixel(), the per-pixel path it replaces, pixel for pixel.
+
+    Every span of every row is drawn in every colour and relative intensity over a frame of random pixels, and
+    with the frame at each byte offset from a word boundary, so the leading and trailing nibbles and the byte and
+    word loops are all exercised. Spans with x0 > x1 must draw nothing.
+*/
+
+#define FRAME_BYTES (FRAME_TRUE_ROWS * FRAME_TRUE_COLS)
+
+int main(void)
+{
+    static uint8_t background[FRAME_BYTES];
+    static uint8_t storage[2][FRAME_BYTES + sizeof(uint32_t)];
+    uint32_t num_spans = 0;
+    uint32_t num_failures = 0;
+
+    srand(1);
+
+    for (uint32_t i = 0; i < FRAME_BYTES; i++) {
+        background[i] = (uint8_t) rand();
+    }
+
+    for (uint8_t offset = 0; offset < sizeof(uint32_t); offset++) {
+        uint8_t (*expected)[FRAME_TRUE_COLS] = (uint8_t (*)[FRAME_TRUE_COLS]) &storage[0][offset];
+        uint8_t (*actual)[FRAME_TRUE_COLS] = (uint8_t (*)[FRAME_TRUE_COLS]) &storage[1][offset];
+
+        for (uint8_t colour = R; colour <= B; colour++) {
+            for (uint8_t intensity = 0; intensity <= MAX_RELATIVE_INTENSITY; intensity++) {
+                for (uint8_t y = 0; y < FRAME_NUM_ROWS; y++) {
+                    for (uint8_t x0 = 0; x0 < FRAME_NUM_COLS; x0++) {
+                        for (uint8_t x1 = 0; x1 < FRAME_NUM_COLS; x1++) {
+                            memcpy(expected, background, FRAME_BYTES);
+                            memcpy(actual, background, FRAME_BYTES);
+
+                            for (uint8_t x = x0; x <= x1; x++) {
+                                drawPixel(expected, x, y, colour, intensity);
+                            }
+
+                            drawHorizontalLine(actual, y, x0, x1, colour, intensity);
+
+                            num_spans++;
+
+                            if (memcmp(expected, actual, FRAME_BYTES) != 0) {
+                                if (num_failures++ < 10) {
+                                    printf("Span y %d, x %d to %d, colour %d, intensity %d, offset %d differs.\n",
+                                        y, x0, x1, colour, intensity, offset);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    printf("%u spans, %u differ from the per-pixel path.\n", (unsigned int) num_spans, (unsigned int) num_failures);
+
+    return (num_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}